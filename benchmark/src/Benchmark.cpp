@@ -0,0 +1,590 @@
+#include "BenchmarkReport.h"
+#include "Event.h"
+#include "EventManager.h"
+#include "EventRecording.h"
+#include "Layer.h"
+#include "StaticLayerStack.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Description: Dispatch benchmark suite. Run with --format=table|csv|json and optionally --output=<path> and
+// --replay=<recording>
+
+namespace
+{
+
+constexpr size_t BATCH_COUNT = 64;
+constexpr size_t TARGET_CALLS_PER_BATCH = 200'000; // NOTE: Listener calls per batch, keeps every case comparable
+
+uint64_t s_Checksum = 0;
+
+class Receiver
+{
+  public:
+    void OnEvent(ae::Event &event)
+    {
+        m_Sum += event.GetTypeId();
+    }
+
+    [[nodiscard]] uint64_t GetSum() const noexcept
+    {
+        return m_Sum;
+    }
+
+  private:
+    uint64_t m_Sum = 0;
+};
+
+class BenchmarkLayer : public ae::Layer
+{
+  public:
+    explicit BenchmarkLayer(bool consume) : Layer("BenchmarkLayer"), m_Consume(consume) {}
+
+    [[nodiscard]] uint64_t GetSum() const noexcept
+    {
+        return m_Sum;
+    }
+
+  private:
+    void OnEvent(ae::Event &event) override
+    {
+        m_Sum += event.GetTypeId();
+
+        if (m_Consume)
+        {
+            event.Consume();
+        }
+    }
+
+  private:
+    bool m_Consume;
+    uint64_t m_Sum = 0;
+};
+
+// NOTE: Same work as BenchmarkLayer, for a StaticLayerStack. The index only makes each layer a distinct type
+template <size_t I> class StaticBenchmarkLayer
+{
+  public:
+    void OnEvent(ae::Event &event)
+    {
+        m_Sum += event.GetTypeId();
+    }
+
+    [[nodiscard]] uint64_t GetSum() const noexcept
+    {
+        return m_Sum;
+    }
+
+  private:
+    uint64_t m_Sum = 0;
+};
+
+// NOTE: Times BATCH_COUNT runs of a batch and reports per-operation timings. The median and p99 are taken over the
+// per-batch averages, so they show jitter between batches rather than the cost of a single call
+template <typename Batch>
+bench::BenchmarkResult Measure(const char *pSuite, const char *pCase, size_t parameter, size_t operationsPerBatch,
+                               Batch &&batch)
+{
+    std::array<double, BATCH_COUNT> samples{};
+    double totalNanoseconds = 0.0;
+
+    // NOTE: Warm up caches and let the listener storage settle before timing
+    batch();
+
+    for (double &sample : samples)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        batch();
+        const auto end = std::chrono::steady_clock::now();
+
+        const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+        totalNanoseconds += nanoseconds;
+        sample = nanoseconds / static_cast<double>(operationsPerBatch);
+    }
+
+    std::ranges::sort(samples);
+
+    return bench::BenchmarkResult{ .Suite = pSuite,
+                                   .Case = pCase,
+                                   .Parameter = parameter,
+                                   .Operations = operationsPerBatch * BATCH_COUNT,
+                                   .MeanNs = totalNanoseconds / static_cast<double>(operationsPerBatch * BATCH_COUNT),
+                                   .MedianNs = samples[BATCH_COUNT / 2],
+                                   .P99Ns = samples[(BATCH_COUNT * 99) / 100] };
+}
+
+void Verify(bool condition, const char *pSuite)
+{
+    if (!condition)
+    {
+        std::fprintf(stderr, "Benchmark checksum mismatch in suite '%s'\n", pSuite);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+size_t GetDispatchCount(size_t callsPerDispatch)
+{
+    return std::max<size_t>(TARGET_CALLS_PER_BATCH / std::max<size_t>(callsPerDispatch, 1), 1);
+}
+
+// NOTE: Cost of one Dispatch() against the number of listeners for its type, for both callback kinds
+void BenchmarkListeners(bench::BenchmarkReport &report)
+{
+    for (size_t listenerCount : { 1, 10, 100, 1000, 10000 })
+    {
+        const size_t dispatchCount = GetDispatchCount(listenerCount);
+
+        for (bool useDelegate : { false, true })
+        {
+            std::vector<Receiver> receivers(listenerCount);
+            std::vector<ae::EventListener> listeners;
+            listeners.reserve(listenerCount);
+
+            for (Receiver &receiver : receivers)
+            {
+                if (useDelegate)
+                {
+                    listeners.emplace_back(ae::EventDelegate::Bind<&Receiver::OnEvent>(&receiver));
+                }
+                else
+                {
+                    listeners.emplace_back([&receiver](ae::Event &event) { receiver.OnEvent(event); });
+                }
+            }
+
+            ae::MouseMovedEvent event(1.0f, 2.0f);
+
+            report.Add(Measure("listeners", useDelegate ? "delegate" : "function", listenerCount, dispatchCount,
+                               [&]
+                               {
+                                   for (size_t i = 0; i < dispatchCount; i++)
+                                   {
+                                       event.Dispatch();
+                                   }
+                               }));
+
+            uint64_t checksum = 0;
+
+            for (const Receiver &receiver : receivers)
+            {
+                checksum += receiver.GetSum();
+            }
+
+            Verify(checksum == static_cast<uint64_t>(event.GetTypeId()) * listenerCount * dispatchCount *
+                                   (BATCH_COUNT + 1),
+                   "listeners");
+        }
+    }
+}
+
+// NOTE: Round-robin over a growing number of event types, each with its own typed listeners. The catch-all case
+// registers as many untyped listeners per type in the mix instead, so every listener sees every event
+void BenchmarkTypeMix(bench::BenchmarkReport &report)
+{
+    constexpr size_t LISTENERS_PER_TYPE = 16;
+
+    ae::MouseMovedEvent mouseMoved(1.0f, 2.0f);
+    ae::MouseScrolledEvent mouseScrolled(0.0f, 1.0f);
+    ae::MouseButtonPressedEvent mouseButtonPressed(0);
+    ae::KeyPressedEvent keyPressed(65);
+    ae::KeyReleasedEvent keyReleased(65);
+    ae::WindowResizeEvent windowResize(1280, 720);
+    ae::WindowMovedEvent windowMoved(10, 20);
+    ae::WindowFocusedEvent windowFocused(true);
+
+    const std::array<ae::Event *, 8> pEvents = { &mouseMoved, &keyPressed, &windowResize, &mouseScrolled,
+                                                 &keyReleased, &windowMoved, &mouseButtonPressed, &windowFocused };
+
+    for (size_t typeCount : { 1, 2, 4, 8 })
+    {
+        const size_t dispatchCount = GetDispatchCount(LISTENERS_PER_TYPE);
+
+        for (bool typed : { true, false })
+        {
+            Receiver receiver;
+            std::vector<ae::EventListener> listeners;
+
+            for (size_t type = 0; type < pEvents.size(); type++)
+            {
+                for (size_t i = 0; i < LISTENERS_PER_TYPE; i++)
+                {
+                    auto delegate = ae::EventDelegate::Bind<&Receiver::OnEvent>(&receiver);
+
+                    if (typed)
+                    {
+                        listeners.emplace_back(pEvents[type]->GetTypeId(), delegate);
+                    }
+                    else if (type < typeCount)
+                    {
+                        listeners.emplace_back(delegate);
+                    }
+                }
+            }
+
+            report.Add(Measure("type-mix", typed ? "typed" : "catch-all", typeCount, dispatchCount,
+                               [&]
+                               {
+                                   for (size_t i = 0; i < dispatchCount; i++)
+                                   {
+                                       pEvents[i % typeCount]->Dispatch();
+                                   }
+                               }));
+
+            s_Checksum += receiver.GetSum();
+        }
+    }
+}
+
+// NOTE: Replaces listeners between dispatches. Every replacement destroys one listener, constructs one and moves it
+// into place, which exercises the slot free list and swap-and-pop removal
+void BenchmarkChurn(bench::BenchmarkReport &report)
+{
+    constexpr size_t LISTENER_COUNT = 1000;
+
+    for (size_t churnPerDispatch : { 0, 1, 8, 64 })
+    {
+        const size_t dispatchCount = GetDispatchCount(LISTENER_COUNT);
+
+        Receiver receiver;
+        std::vector<ae::EventListener> listeners;
+        listeners.reserve(LISTENER_COUNT);
+
+        for (size_t i = 0; i < LISTENER_COUNT; i++)
+        {
+            listeners.push_back(ae::EventListener::For<ae::MouseMovedEvent>(
+                ae::EventDelegate::Bind<&Receiver::OnEvent>(&receiver)));
+        }
+
+        ae::MouseMovedEvent event(1.0f, 2.0f);
+        size_t next = 0;
+
+        report.Add(Measure("churn", "replace", churnPerDispatch, dispatchCount,
+                           [&]
+                           {
+                               for (size_t i = 0; i < dispatchCount; i++)
+                               {
+                                   event.Dispatch();
+
+                                   for (size_t j = 0; j < churnPerDispatch; j++)
+                                   {
+                                       ae::EventListener listener = ae::EventListener::For<ae::MouseMovedEvent>(
+                                           ae::EventDelegate::Bind<&Receiver::OnEvent>(&receiver));
+                                       listeners[next] = std::move(listener);
+                                       next = (next + 1) % LISTENER_COUNT;
+                                   }
+                               }
+                           }));
+
+        Verify(receiver.GetSum() ==
+                   static_cast<uint64_t>(event.GetTypeId()) * LISTENER_COUNT * dispatchCount * (BATCH_COUNT + 1),
+               "churn");
+    }
+}
+
+// NOTE: One event through a LayerStack. With consumption the top layer stops propagation, which is the best case
+void BenchmarkLayers(bench::BenchmarkReport &report)
+{
+    for (size_t layerCount : { 1, 4, 16, 64 })
+    {
+        const size_t dispatchCount = GetDispatchCount(layerCount);
+
+        for (bool consume : { false, true })
+        {
+            std::vector<std::unique_ptr<BenchmarkLayer>> layers;
+            ae::LayerStack layerStack;
+
+            for (size_t i = 0; i < layerCount; i++)
+            {
+                // NOTE: Events reach the most recently pushed layer first, so it is the one that consumes
+                const bool isTop = i + 1 == layerCount;
+                layers.push_back(std::make_unique<BenchmarkLayer>(consume && isTop));
+                layerStack.PushLayer(layers.back().get());
+            }
+
+            ae::MouseMovedEvent event(1.0f, 2.0f);
+
+            report.Add(Measure("layers", consume ? "consume-top" : "propagate", layerCount, dispatchCount,
+                               [&]
+                               {
+                                   for (size_t i = 0; i < dispatchCount; i++)
+                                   {
+                                       event.Dispatch();
+                                   }
+                               }));
+
+            uint64_t checksum = 0;
+
+            for (const auto &pLayer : layers)
+            {
+                checksum += pLayer->GetSum();
+            }
+
+            const size_t receivingLayers = consume ? 1 : layerCount;
+            Verify(checksum == static_cast<uint64_t>(event.GetTypeId()) * receivingLayers * dispatchCount *
+                                   (BATCH_COUNT + 1),
+                   "layers");
+
+            for (const auto &pLayer : layers)
+            {
+                layerStack.PopLayer(pLayer.get());
+            }
+        }
+    }
+}
+
+// NOTE: One event through a StaticLayerStack, directly comparable to the propagating case of BenchmarkLayers()
+void BenchmarkStaticLayers(bench::BenchmarkReport &report)
+{
+    using Stack = ae::StaticLayerStack<StaticBenchmarkLayer<0>, StaticBenchmarkLayer<1>, StaticBenchmarkLayer<2>,
+                                       StaticBenchmarkLayer<3>>;
+
+    const size_t dispatchCount = GetDispatchCount(Stack::LAYER_COUNT);
+
+    Stack layerStack;
+    ae::MouseMovedEvent event(1.0f, 2.0f);
+
+    report.Add(Measure("layers", "static-propagate", Stack::LAYER_COUNT, dispatchCount,
+                       [&]
+                       {
+                           for (size_t i = 0; i < dispatchCount; i++)
+                           {
+                               event.Dispatch();
+                           }
+                       }));
+
+    const uint64_t checksum = layerStack.Get<StaticBenchmarkLayer<0>>().GetSum() +
+                              layerStack.Get<StaticBenchmarkLayer<1>>().GetSum() +
+                              layerStack.Get<StaticBenchmarkLayer<2>>().GetSum() +
+                              layerStack.Get<StaticBenchmarkLayer<3>>().GetSum();
+
+    Verify(checksum == static_cast<uint64_t>(event.GetTypeId()) * Stack::LAYER_COUNT * dispatchCount *
+                           (BATCH_COUNT + 1),
+           "layers");
+}
+
+// NOTE: Per event cost of immediate Dispatch(), Enqueue() plus Flush() and Post() plus Flush() for a frame of events.
+// Key events are used because they never coalesce, so every queued event is dispatched
+void BenchmarkQueueModes(bench::BenchmarkReport &report)
+{
+    constexpr size_t LISTENER_COUNT = 10;
+
+    ae::EventManager &eventManager = ae::EventManager::Get();
+
+    for (size_t eventsPerFrame : { 1, 64, 1024 })
+    {
+        const size_t frameCount = GetDispatchCount(LISTENER_COUNT * eventsPerFrame);
+        const size_t operations = frameCount * eventsPerFrame;
+
+        Receiver receiver;
+        std::vector<ae::EventListener> listeners;
+
+        for (size_t i = 0; i < LISTENER_COUNT; i++)
+        {
+            listeners.push_back(ae::EventListener::For<ae::KeyPressedEvent>(
+                ae::EventDelegate::Bind<&Receiver::OnEvent>(&receiver)));
+        }
+
+        report.Add(Measure("queue", "immediate", eventsPerFrame, operations,
+                           [&]
+                           {
+                               for (size_t frame = 0; frame < frameCount; frame++)
+                               {
+                                   for (size_t i = 0; i < eventsPerFrame; i++)
+                                   {
+                                       ae::KeyPressedEvent event(static_cast<int32_t>(i));
+                                       event.Dispatch();
+                                   }
+                               }
+                           }));
+
+        report.Add(Measure("queue", "enqueue-flush", eventsPerFrame, operations,
+                           [&]
+                           {
+                               for (size_t frame = 0; frame < frameCount; frame++)
+                               {
+                                   for (size_t i = 0; i < eventsPerFrame; i++)
+                                   {
+                                       eventManager.Enqueue<ae::KeyPressedEvent>(static_cast<int32_t>(i));
+                                   }
+
+                                   eventManager.Flush();
+                               }
+                           }));
+
+        report.Add(Measure("queue", "post-flush", eventsPerFrame, operations,
+                           [&]
+                           {
+                               for (size_t frame = 0; frame < frameCount; frame++)
+                               {
+                                   for (size_t i = 0; i < eventsPerFrame; i++)
+                                   {
+                                       static_cast<void>(
+                                           eventManager.Post<ae::KeyPressedEvent>(static_cast<int32_t>(i)));
+                                   }
+
+                                   eventManager.Flush();
+                               }
+                           }));
+
+        Verify(receiver.GetSum() == static_cast<uint64_t>(ae::EventTypeId<ae::KeyPressedEvent>::Get()) *
+                                        LISTENER_COUNT * operations * (BATCH_COUNT + 1) * 3,
+               "queue");
+    }
+}
+
+void DiscardEvent(ae::Event &) {}
+
+// NOTE: A recorded session replayed as fast as possible into a LayerStack, so layer cost is measured against
+// production-shaped input. Every layer propagates, so they all see the same events
+bool BenchmarkReplay(bench::BenchmarkReport &report, const char *pRecordingPath)
+{
+    ae::EventReplay replay;
+
+    if (!replay.Open(pRecordingPath))
+    {
+        std::fprintf(stderr, "Failed to open the recording '%s'\n", pRecordingPath);
+        return false;
+    }
+
+    const size_t eventCount = replay.ReplayAll(ae::EventDelegate::Bind<&DiscardEvent>());
+
+    if (eventCount == 0)
+    {
+        std::fprintf(stderr, "The recording '%s' contains no replayable events\n", pRecordingPath);
+        return false;
+    }
+
+    for (size_t layerCount : { 1, 4, 16 })
+    {
+        std::vector<std::unique_ptr<BenchmarkLayer>> layers;
+        ae::LayerStack layerStack;
+
+        for (size_t i = 0; i < layerCount; i++)
+        {
+            layers.push_back(std::make_unique<BenchmarkLayer>(false));
+            layerStack.PushLayer(layers.back().get());
+        }
+
+        const ae::EventDelegate target = ae::EventDelegate::Bind<&ae::LayerStack::OnEvent>(&layerStack);
+
+        report.Add(Measure("replay", "layers", layerCount, eventCount,
+                           [&]
+                           {
+                               replay.Rewind();
+                               replay.ReplayAll(target);
+                           }));
+
+        for (const auto &pLayer : layers)
+        {
+            Verify(pLayer->GetSum() == layers.front()->GetSum(), "replay");
+            layerStack.PopLayer(pLayer.get());
+        }
+    }
+
+    return true;
+}
+
+bool ParseArguments(int argc, char **argv, bench::ReportFormat &format, const char *&pOutputPath,
+                    const char *&pReplayPath)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view argument = argv[i];
+
+        if (argument == "--format=table")
+        {
+            format = bench::ReportFormat::TABLE;
+        }
+        else if (argument == "--format=csv")
+        {
+            format = bench::ReportFormat::CSV;
+        }
+        else if (argument == "--format=json")
+        {
+            format = bench::ReportFormat::JSON;
+        }
+        else if (argument.starts_with("--output="))
+        {
+            pOutputPath = argv[i] + std::strlen("--output=");
+        }
+        else if (argument.starts_with("--replay="))
+        {
+            pReplayPath = argv[i] + std::strlen("--replay=");
+        }
+        else
+        {
+            std::fprintf(stderr,
+                         "Unknown argument '%s'\n"
+                         "Usage: Benchmark [--format=table|csv|json] [--output=path] [--replay=recording]\n",
+                         argv[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        bench::ReportFormat format = bench::ReportFormat::TABLE;
+        const char *pOutputPath = nullptr;
+        const char *pReplayPath = nullptr;
+
+        if (!ParseArguments(argc, argv, format, pOutputPath, pReplayPath))
+        {
+            return EXIT_FAILURE;
+        }
+
+        bench::BenchmarkReport report;
+
+        BenchmarkListeners(report);
+        BenchmarkTypeMix(report);
+        BenchmarkChurn(report);
+        BenchmarkLayers(report);
+        BenchmarkStaticLayers(report);
+        BenchmarkQueueModes(report);
+
+        if (pReplayPath != nullptr && !BenchmarkReplay(report, pReplayPath))
+        {
+            return EXIT_FAILURE;
+        }
+
+        std::FILE *pFile = pOutputPath != nullptr ? std::fopen(pOutputPath, "w") : stdout;
+
+        if (pFile == nullptr)
+        {
+            std::fprintf(stderr, "Failed to open '%s' for writing\n", pOutputPath);
+            return EXIT_FAILURE;
+        }
+
+        report.Write(pFile, format);
+
+        if (pFile != stdout)
+        {
+            std::fclose(pFile);
+        }
+
+        // NOTE: Keeps the type mix receivers observable so their work is not optimized away
+        return s_Checksum != 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    catch (...)
+    {
+        std::fputs("Fatal error: unknown exception\n", stderr);
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,105 @@
+#include "BenchmarkReport.h"
+
+#include <utility>
+
+namespace
+{
+
+const char *GetBuildConfig() noexcept
+{
+#if defined(AE_DEBUG)
+    return "debug";
+#elif defined(AE_RELEASE)
+    return "release";
+#elif defined(AE_DIST)
+    return "dist";
+#else
+    return "unknown";
+#endif
+}
+
+const char *GetCompiler() noexcept
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc";
+#else
+    return "unknown";
+#endif
+}
+
+double GetOperationsPerSecond(const bench::BenchmarkResult &result) noexcept
+{
+    return result.MeanNs > 0.0 ? 1e9 / result.MeanNs : 0.0;
+}
+
+} // namespace
+
+void bench::BenchmarkReport::Add(BenchmarkResult result)
+{
+    m_Results.push_back(std::move(result));
+}
+
+void bench::BenchmarkReport::Write(std::FILE *pFile, ReportFormat format) const
+{
+    switch (format)
+    {
+    case ReportFormat::TABLE:
+        WriteTable(pFile);
+        break;
+    case ReportFormat::CSV:
+        WriteCsv(pFile);
+        break;
+    case ReportFormat::JSON:
+        WriteJson(pFile);
+        break;
+    }
+}
+
+void bench::BenchmarkReport::WriteTable(std::FILE *pFile) const
+{
+    std::fprintf(pFile, "%-10s %-16s %10s %12s %12s %12s %14s\n", "suite", "case", "param", "mean ns", "median ns",
+                 "p99 ns", "ops/s");
+
+    for (const BenchmarkResult &result : m_Results)
+    {
+        std::fprintf(pFile, "%-10s %-16s %10zu %12.2f %12.2f %12.2f %14.0f\n", result.Suite.c_str(),
+                     result.Case.c_str(), result.Parameter, result.MeanNs, result.MedianNs, result.P99Ns,
+                     GetOperationsPerSecond(result));
+    }
+}
+
+void bench::BenchmarkReport::WriteCsv(std::FILE *pFile) const
+{
+    std::fputs("suite,case,parameter,operations,mean_ns,median_ns,p99_ns,ops_per_second\n", pFile);
+
+    for (const BenchmarkResult &result : m_Results)
+    {
+        std::fprintf(pFile, "%s,%s,%zu,%zu,%.3f,%.3f,%.3f,%.0f\n", result.Suite.c_str(), result.Case.c_str(),
+                     result.Parameter, result.Operations, result.MeanNs, result.MedianNs, result.P99Ns,
+                     GetOperationsPerSecond(result));
+    }
+}
+
+void bench::BenchmarkReport::WriteJson(std::FILE *pFile) const
+{
+    // NOTE: Suite and case names are fixed identifiers without characters that need escaping
+    std::fprintf(pFile, "{\n  \"config\": \"%s\",\n  \"compiler\": \"%s\",\n  \"results\": [", GetBuildConfig(),
+                 GetCompiler());
+
+    for (size_t i = 0; i < m_Results.size(); i++)
+    {
+        const BenchmarkResult &result = m_Results[i];
+
+        std::fprintf(pFile,
+                     "%s\n    { \"suite\": \"%s\", \"case\": \"%s\", \"parameter\": %zu, \"operations\": %zu, "
+                     "\"mean_ns\": %.3f, \"median_ns\": %.3f, \"p99_ns\": %.3f, \"ops_per_second\": %.0f }",
+                     i == 0 ? "" : ",", result.Suite.c_str(), result.Case.c_str(), result.Parameter,
+                     result.Operations, result.MeanNs, result.MedianNs, result.P99Ns, GetOperationsPerSecond(result));
+    }
+
+    std::fputs("\n  ]\n}\n", pFile);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+// NOTE: Timings are per operation, where an operation is one Dispatch(), one queued event or one layer stack event
+struct BenchmarkResult
+{
+    std::string Suite;
+    std::string Case;
+    size_t Parameter = 0;
+    size_t Operations = 0;
+    double MeanNs = 0.0;
+    double MedianNs = 0.0;
+    double P99Ns = 0.0;
+};
+
+enum class ReportFormat
+{
+    TABLE,
+    CSV,
+    JSON
+};
+
+class BenchmarkReport
+{
+  public:
+    void Add(BenchmarkResult result);
+
+    // NOTE: CSV and JSON keep a stable column set so results can be diffed between releases
+    void Write(std::FILE *pFile, ReportFormat format) const;
+
+    [[nodiscard]] const std::vector<BenchmarkResult> &GetResults() const noexcept
+    {
+        return m_Results;
+    }
+
+  private:
+    void WriteTable(std::FILE *pFile) const;
+
+    void WriteCsv(std::FILE *pFile) const;
+
+    void WriteJson(std::FILE *pFile) const;
+
+  private:
+    std::vector<BenchmarkResult> m_Results;
+};
+
+} // namespace bench
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Event.h"
+#include "EventManager.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+
+// NOTE: Completion latch shared by async listeners. The frame loop calls Wait() before it needs their results, for
+// example before OnRender(). Must outlive its listeners
+class AsyncEventGroup
+{
+    template <typename T> friend class AsyncEventListener;
+
+  public:
+    explicit AsyncEventGroup(ThreadPool &threadPool) noexcept : m_ThreadPool(threadPool)
+    {
+    }
+
+    AsyncEventGroup(const AsyncEventGroup &) = delete;
+    AsyncEventGroup &operator=(const AsyncEventGroup &) = delete;
+    AsyncEventGroup(AsyncEventGroup &&) = delete;
+    AsyncEventGroup &operator=(AsyncEventGroup &&) = delete;
+
+    ~AsyncEventGroup()
+    {
+        Wait();
+    }
+
+    // NOTE: Helps run queued tasks on the calling thread until every handler dispatched so far has returned
+    void Wait()
+    {
+        m_ThreadPool.Wait(m_Latch);
+    }
+
+    [[nodiscard]] bool IsDone() const noexcept
+    {
+        return m_Latch.IsDone();
+    }
+
+    [[nodiscard]] ThreadPool &GetThreadPool() const noexcept
+    {
+        return m_ThreadPool;
+    }
+
+  private:
+    ThreadPool &m_ThreadPool;
+    TaskLatch m_Latch;
+};
+
+// NOTE: The copy of an event an async job owns until its callback returns. Events that view data they do not own
+// (EventPayloadTraits::HAS_EXTERNAL_PAYLOAD) need a specialization that copies that data as well, since it may be
+// released while the job runs. Queued events, for example, view the frame arena that the flush resets right after
+template <typename T> struct AsyncEventCopy
+{
+    static_assert(!EventPayloadTraits<T>::HAS_EXTERNAL_PAYLOAD,
+                  "Async event views data that may be released before the job runs, specialize ae::AsyncEventCopy");
+
+    std::optional<T> Event;
+
+    void Store(const T &event)
+    {
+        Event.emplace(event);
+    }
+};
+
+// NOTE: The paths are copied into strings owned by the job, which keep their capacity between drops
+template <> struct AsyncEventCopy<FileDropEvent>
+{
+    std::vector<std::string> Paths;
+    std::vector<std::string_view> Views;
+    std::optional<FileDropEvent> Event;
+
+    void Store(const FileDropEvent &event)
+    {
+        const std::span<const std::string_view> paths = event.GetPaths();
+
+        if (Paths.size() < paths.size())
+        {
+            Paths.resize(paths.size());
+        }
+
+        Views.clear();
+
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            Paths[i].assign(paths[i]);
+            Views.emplace_back(Paths[i]);
+        }
+
+        Event.emplace(std::span<const std::string_view>(Views));
+    }
+};
+
+// NOTE: Listener for one event type whose callback runs on a ThreadPool worker instead of inside the dispatch. Each
+// dispatch copies the event into a reusable job through AsyncEventCopy, so the steady state neither allocates nor
+// spawns threads, and the job owns everything the event refers to until the callback returns. Callbacks of one
+// listener may run concurrently for different events, cannot consume the event, and should hand results back through
+// EventBus::Post(). Waits for the group on destruction
+template <typename T> class AsyncEventListener
+{
+    static_assert(std::is_base_of_v<Event, T>, "Async event type must derive from ae::Event");
+    static_assert(std::is_copy_constructible_v<T>, "Async event must be copy constructible");
+
+  public:
+    using Callback = std::function<void(T &)>;
+
+  public:
+    AsyncEventListener(AsyncEventGroup &group, Callback callback)
+        : AsyncEventListener(EventManager::Get(), group, std::move(callback))
+    {
+    }
+
+    AsyncEventListener(EventBus &bus, AsyncEventGroup &group, Callback callback)
+        : m_Group(group), m_Callback(std::move(callback)),
+          m_Listener(std::in_place, bus, EventTypeId<T>::Get(), EventDelegate::Bind<&AsyncEventListener::OnEvent>(this))
+    {
+    }
+
+    AsyncEventListener(const AsyncEventListener &) = delete;
+    AsyncEventListener &operator=(const AsyncEventListener &) = delete;
+    AsyncEventListener(AsyncEventListener &&) = delete;
+    AsyncEventListener &operator=(AsyncEventListener &&) = delete;
+
+    ~AsyncEventListener()
+    {
+        // NOTE: No dispatch can reach the listener once it is gone, but queued jobs still point at it
+        m_Listener.reset();
+        m_Group.Wait();
+    }
+
+    // NOTE: Priority and enabling work as for any other listener and apply to the dispatch that queues the job
+    [[nodiscard]] EventListener &GetListener() noexcept
+    {
+        return *m_Listener;
+    }
+
+    [[nodiscard]] AsyncEventGroup &GetGroup() const noexcept
+    {
+        return m_Group;
+    }
+
+    // NOTE: Jobs allocated so far, the most events of this listener that were in flight at once
+    [[nodiscard]] size_t GetJobCount() const noexcept
+    {
+        return m_pJobs.size();
+    }
+
+  private:
+    struct Job
+    {
+        AsyncEventListener *pOwner = nullptr;
+        AsyncEventCopy<T> Copy;
+        std::atomic<bool> Busy = false; // NOTE: Cleared by the worker once the callback returned
+    };
+
+  private:
+    void OnEvent(T &event)
+    {
+        Job &job = AcquireJob();
+        job.Copy.Store(event);
+        job.Busy.store(true, std::memory_order_relaxed);
+
+        // NOTE: Submitting publishes the copy to the worker that runs the job
+        m_Group.m_ThreadPool.Submit(Task{ .pFunction = &RunJob, .pContext = &job }, m_Group.m_Latch);
+    }
+
+    static void RunJob(void *pContext)
+    {
+        auto &job = *static_cast<Job *>(pContext);
+        job.pOwner->m_Callback(*job.Copy.Event);
+        job.Copy.Event.reset();
+        job.Busy.store(false, std::memory_order_release);
+    }
+
+    // NOTE: Round-robin over the jobs, so a free one is usually found at the cursor. Only grows while every job is
+    // still in flight
+    [[nodiscard]] Job &AcquireJob()
+    {
+        const size_t jobCount = m_pJobs.size();
+
+        for (size_t i = 0; i < jobCount; i++)
+        {
+            const size_t index = (m_NextJob + i) % jobCount;
+
+            if (!m_pJobs[index]->Busy.load(std::memory_order_acquire))
+            {
+                m_NextJob = index + 1;
+                return *m_pJobs[index];
+            }
+        }
+
+        m_pJobs.push_back(std::make_unique<Job>());
+        m_pJobs.back()->pOwner = this;
+        m_NextJob = 0;
+        return *m_pJobs.back();
+    }
+
+  private:
+    AsyncEventGroup &m_Group;
+    Callback m_Callback;
+    std::vector<std::unique_ptr<Job>> m_pJobs; // NOTE: Jobs never move, queued tasks point at them
+    size_t m_NextJob = 0;
+    std::optional<EventListener> m_Listener;
+};
+
+} // namespace ae
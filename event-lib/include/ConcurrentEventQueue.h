@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Event.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ae
+{
+
+struct ConcurrentEventQueueStats
+{
+    size_t Capacity = 0;
+    size_t Depth = 0;        // NOTE: Events waiting to be drained when the stats were read
+    size_t MaxDepth = 0;     // NOTE: Highest depth seen at the start of a drain
+    uint64_t Posted = 0;     // NOTE: Events successfully posted
+    uint64_t Overflowed = 0; // NOTE: Events dropped because the queue was full
+};
+
+// NOTE: Bounded lock-free multi-producer single-consumer queue. Any thread may post, a single thread drains.
+// Events are stored by value in fixed-size slots, so posting never allocates and never takes a lock
+class ConcurrentEventQueue
+{
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+    static constexpr size_t MAX_EVENT_SIZE = MAX_INLINE_EVENT_SIZE;
+
+    explicit ConcurrentEventQueue(size_t capacity = DEFAULT_CAPACITY);
+    ConcurrentEventQueue(const ConcurrentEventQueue &) = delete;
+    ConcurrentEventQueue &operator=(const ConcurrentEventQueue &) = delete;
+    ConcurrentEventQueue(ConcurrentEventQueue &&) = delete;
+    ConcurrentEventQueue &operator=(ConcurrentEventQueue &&) = delete;
+    ~ConcurrentEventQueue() = default; // NOTE: Slots destroy events that were posted but never drained
+
+    // NOTE: Returns false and counts an overflow if the queue is full
+    template <typename T, typename... Args> bool TryEmplace(Args &&...args)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "Posted type must derive from ae::Event");
+        static_assert(sizeof(T) <= MAX_EVENT_SIZE, "Posted event does not fit in a queue slot");
+        static_assert(alignof(T) <= MAX_INLINE_EVENT_ALIGNMENT, "Posted event is over-aligned");
+
+        Slot *pSlot = AcquireSlot();
+
+        if (pSlot == nullptr)
+        {
+            return false;
+        }
+
+        pSlot->Storage.Emplace<T>(std::forward<Args>(args)...);
+        PublishSlot(pSlot);
+        return true;
+    }
+
+    // NOTE: Must only be called from the consumer thread. Dispatches at most the events that were posted when the
+    // drain started, so producers cannot keep the consumer busy forever. Returns the number of dispatched events.
+    // A drain from inside a dispatched listener is ignored
+    size_t Drain(EventDelegate dispatch);
+
+    [[nodiscard]] ConcurrentEventQueueStats GetStats() const noexcept;
+
+    [[nodiscard]] size_t GetCapacity() const noexcept
+    {
+        return m_Capacity;
+    }
+
+  private:
+    // NOTE: One cache line per slot so producers writing neighbouring slots do not share lines
+    struct alignas(64) Slot
+    {
+        std::atomic<size_t> Sequence;
+        EventStorage Storage;
+    };
+
+    static_assert(sizeof(Slot) == 64, "A queue slot must fill exactly one cache line");
+
+  private:
+    [[nodiscard]] Slot *AcquireSlot() noexcept;
+
+    void PublishSlot(Slot *pSlot) noexcept;
+
+  private:
+    std::unique_ptr<Slot[]> m_pSlots;
+    size_t m_Capacity;
+    size_t m_Mask;
+
+    alignas(64) std::atomic<size_t> m_Tail = 0; // NOTE: Claimed by producers
+    alignas(64) std::atomic<size_t> m_Head = 0; // NOTE: Only written by the consumer, read for stats
+    std::atomic<uint64_t> m_Posted = 0;
+    std::atomic<uint64_t> m_Overflowed = 0;
+    std::atomic<size_t> m_MaxDepth = 0;
+    uint64_t m_ReportedOverflows = 0;
+    bool m_Draining = false;
+};
+
+} // namespace ae
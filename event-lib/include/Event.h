@@ -1,9 +1,15 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
-#include <string>
-#include <vector>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace ae
 {
@@ -74,6 +80,13 @@ enum class EventType : uint16_t
     CUSTOM_START = 1000
 };
 
+// NOTE: Event stores its type id in 16 bits, which leaves room for 64535 custom types
+inline constexpr uint32_t MAX_EVENT_TYPE_ID = UINT16_MAX - 1;
+
+// NOTE: The id of custom types registered after every id was taken. It survives the 16-bit storage but maps to no
+// type, so listeners for it are refused instead of being mistaken for catch-all listeners
+inline constexpr uint32_t INVALID_EVENT_TYPE_ID = UINT16_MAX;
+
 enum class EventCategory : uint8_t
 {
     NONE = 0,
@@ -130,6 +143,11 @@ class EventCategoryWrapper
         return *this;
     }
 
+    [[nodiscard]] constexpr uint8_t GetValue() const noexcept
+    {
+        return m_Value;
+    }
+
   private:
     explicit constexpr EventCategoryWrapper(uint8_t value) noexcept : m_Value(value) {}
 
@@ -146,26 +164,33 @@ class EventCategoryWrapper
     return EventCategoryWrapper(a) & EventCategoryWrapper(b);
 }
 
-class EventManager;
+class EventBus;
+
+enum class EventPropagation : uint8_t
+{
+    ALL_LISTENERS = 0,   // NOTE: Every listener runs and sees a non-consumed event
+    STOP_ON_CONSUME = 1, // NOTE: Listeners run in priority order until one consumes the event
+};
 
 class Event
 {
-    friend class EventManager;
+    friend class EventBus;
 
   public:
-    constexpr Event(uint16_t typeId, EventCategory category) noexcept
-        : m_TypeId(typeId), m_Categories(category), m_Consumed(false)
+    // NOTE: Ids are stored in 16 bits to keep small events small. Every id handed out is at most MAX_EVENT_TYPE_ID
+    constexpr Event(uint32_t typeId, EventCategory category) noexcept
+        : m_TypeId(static_cast<uint16_t>(typeId)), m_Categories(category), m_Consumed(false)
     {
     }
 
-    constexpr Event(uint16_t typeId, EventCategoryWrapper categories) noexcept
-        : m_TypeId(typeId), m_Categories(categories), m_Consumed(false)
+    constexpr Event(uint32_t typeId, EventCategoryWrapper categories) noexcept
+        : m_TypeId(static_cast<uint16_t>(typeId)), m_Categories(categories), m_Consumed(false)
     {
     }
 
     ~Event() = default;
 
-    void Dispatch();
+    void Dispatch(EventPropagation propagation = EventPropagation::ALL_LISTENERS);
 
     constexpr void Consume() noexcept
     {
@@ -177,7 +202,7 @@ class Event
         return m_Consumed;
     }
 
-    [[nodiscard]] constexpr uint16_t GetTypeId() const noexcept
+    [[nodiscard]] constexpr uint32_t GetTypeId() const noexcept
     {
         return m_TypeId;
     }
@@ -198,17 +223,301 @@ class Event
     bool m_Consumed;
 };
 
+static_assert(sizeof(Event) == 4, "The event header is a 16-bit id, the category mask and the consumed flag");
+
+// NOTE: Largest event the fixed-size stores hold inline: posted events, timers and trailing throttles. Alignment is
+// capped at 8 rather than std::max_align_t, so an EventStorage plus a 64-bit word fills exactly one cache line
+inline constexpr size_t MAX_INLINE_EVENT_SIZE = 48;
+inline constexpr size_t MAX_INLINE_EVENT_ALIGNMENT = alignof(uint64_t);
+
+// NOTE: Specialize for event types that point at data they do not own, such as FileDropEvent paths. Copies of them
+// share that data, so they are not PodEvents even when trivially copyable
+template <typename T> struct EventPayloadTraits
+{
+    static constexpr bool HAS_EXTERNAL_PAYLOAD = false;
+};
+
+// NOTE: An event whose bytes are the whole event. It can be copied with memcpy into dense arrays, needs no
+// destructor and fits an EventStorage. Every built-in type except FileDropEvent is one
+template <typename T>
+concept PodEvent = std::is_base_of_v<Event, T> && std::is_trivially_copyable_v<T> &&
+                   std::is_trivially_destructible_v<T> && sizeof(T) <= MAX_INLINE_EVENT_SIZE &&
+                   alignof(T) <= MAX_INLINE_EVENT_ALIGNMENT && !EventPayloadTraits<T>::HAS_EXTERNAL_PAYLOAD;
+
+// NOTE: Fixed-size slot holding one event of any type by value, without allocating. PodEvents are stored without a
+// destructor call, other types are destroyed through a per-type function when the slot is reset or destroyed
+class EventStorage
+{
+  public:
+    EventStorage() noexcept = default;
+    EventStorage(const EventStorage &) = delete;
+    EventStorage &operator=(const EventStorage &) = delete;
+    EventStorage(EventStorage &&) = delete;
+    EventStorage &operator=(EventStorage &&) = delete;
+
+    ~EventStorage()
+    {
+        Reset();
+    }
+
+    // NOTE: Destroys the held event first
+    template <typename T, typename... Args> T &Emplace(Args &&...args)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "Stored type must derive from ae::Event");
+        static_assert(sizeof(T) <= MAX_INLINE_EVENT_SIZE, "Event does not fit in an EventStorage");
+        static_assert(alignof(T) <= MAX_INLINE_EVENT_ALIGNMENT, "Event is over-aligned for an EventStorage");
+
+        Reset();
+        T *pEvent = new (m_Data) T(std::forward<Args>(args)...);
+        m_pOps = &STORAGE_OPS<T>;
+        return *pEvent;
+    }
+
+    void Reset() noexcept
+    {
+        if (m_pOps != nullptr && m_pOps->pDestroy != nullptr)
+        {
+            m_pOps->pDestroy(m_Data);
+        }
+
+        m_pOps = nullptr;
+    }
+
+    [[nodiscard]] bool HasValue() const noexcept
+    {
+        return m_pOps != nullptr;
+    }
+
+    // NOTE: Only valid while an event is held
+    [[nodiscard]] Event &Get() noexcept
+    {
+        return m_pOps->pGetEvent(m_Data);
+    }
+
+    // NOTE: T must be the type the event was emplaced as
+    template <typename T> [[nodiscard]] T &Get() noexcept
+    {
+        return *std::launder(reinterpret_cast<T *>(m_Data));
+    }
+
+    // NOTE: Moves the held event of type T out and leaves the storage empty
+    template <typename T> [[nodiscard]] T Take() noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        T event(std::move(Get<T>()));
+        Reset();
+        return event;
+    }
+
+  private:
+    struct StorageOps
+    {
+        Event &(*pGetEvent)(void *pData) noexcept;
+        void (*pDestroy)(void *pData) noexcept; // NOTE: nullptr if trivially destructible
+    };
+
+    template <typename T>
+    static constexpr StorageOps STORAGE_OPS = {
+        .pGetEvent = [](void *pData) noexcept -> Event & { return *std::launder(static_cast<T *>(pData)); },
+        .pDestroy = std::is_trivially_destructible_v<T>
+                        ? nullptr
+                        : static_cast<void (*)(void *) noexcept>([](void *pData) noexcept
+                                                                 { std::launder(static_cast<T *>(pData))->~T(); }),
+    };
+
+  private:
+    const StorageOps *m_pOps = nullptr;
+    alignas(MAX_INLINE_EVENT_ALIGNMENT) std::byte m_Data[MAX_INLINE_EVENT_SIZE];
+};
+
+static_assert(sizeof(EventStorage) == MAX_INLINE_EVENT_SIZE + sizeof(void *), "EventStorage must stay compact");
+
 namespace detail
 {
 
-[[nodiscard]] inline uint32_t GetNextCustomEventId() noexcept
+// NOTE: Thread-safe. Ids are dense and contiguous from EventType::CUSTOM_START. Returns INVALID_EVENT_TYPE_ID once
+// every id up to MAX_EVENT_TYPE_ID has been handed out
+[[nodiscard]] uint32_t GetNextCustomEventId() noexcept;
+
+// NOTE: Open on the calling thread while an event is dispatched. Buses open one per dispatch, and a flush opens one
+// around events that were queued from inside a dispatch, so those count as nested as well
+class DispatchScope
+{
+  public:
+    DispatchScope() noexcept;
+    DispatchScope(const DispatchScope &) = delete;
+    DispatchScope &operator=(const DispatchScope &) = delete;
+    ~DispatchScope();
+};
+
+// NOTE: Dispatch scopes open on the calling thread, across every bus. Inside a listener it is 1 for an event that no
+// other event caused, such as input from a window callback, and higher for events dispatched on behalf of another
+[[nodiscard]] uint32_t GetDispatchDepth() noexcept;
+
+inline constexpr uint32_t BUILTIN_EVENT_COUNT = 23;
+
+// NOTE: Maps built-in type ids to 0..BUILTIN_EVENT_COUNT - 1 for array-indexed lookup tables. Any other id maps to
+// BUILTIN_EVENT_COUNT
+[[nodiscard]] constexpr uint32_t GetBuiltinEventIndex(uint32_t typeId) noexcept
+{
+    switch (static_cast<EventType>(typeId))
+    {
+    case EventType::KEY_PRESSED:
+        return 0;
+    case EventType::KEY_RELEASED:
+        return 1;
+    case EventType::KEY_TYPED:
+        return 2;
+    case EventType::MOUSE_BUTTON_PRESSED:
+        return 3;
+    case EventType::MOUSE_BUTTON_RELEASED:
+        return 4;
+    case EventType::MOUSE_MOVED:
+        return 5;
+    case EventType::MOUSE_SCROLLED:
+        return 6;
+    case EventType::MOUSE_ENTERED:
+        return 7;
+    case EventType::MOUSE_EXITED:
+        return 8;
+    case EventType::WINDOW_RESIZE:
+        return 9;
+    case EventType::WINDOW_MINIMIZED:
+        return 10;
+    case EventType::WINDOW_MAXIMIZED:
+        return 11;
+    case EventType::WINDOW_RESTORED:
+        return 12;
+    case EventType::WINDOW_MOVED:
+        return 13;
+    case EventType::WINDOW_FOCUSED:
+        return 14;
+    case EventType::WINDOW_CLOSE:
+        return 15;
+    case EventType::FRAMEBUFFER_RESIZE:
+        return 16;
+    case EventType::CONTENT_SCALE_CHANGED:
+        return 17;
+    case EventType::FILE_DROP:
+        return 18;
+    case EventType::CONTROLLER_CONNECTED:
+        return 19;
+    case EventType::CONTROLLER_DISCONNECTED:
+        return 20;
+    case EventType::APP_UPDATE:
+        return 21;
+    case EventType::APP_RENDER:
+        return 22;
+    default:
+        return BUILTIN_EVENT_COUNT;
+    }
+}
+
+// NOTE: Indexed by GetBuiltinEventIndex()
+inline constexpr std::array<EventType, BUILTIN_EVENT_COUNT> BUILTIN_EVENT_TYPES = {
+    EventType::KEY_PRESSED,
+    EventType::KEY_RELEASED,
+    EventType::KEY_TYPED,
+    EventType::MOUSE_BUTTON_PRESSED,
+    EventType::MOUSE_BUTTON_RELEASED,
+    EventType::MOUSE_MOVED,
+    EventType::MOUSE_SCROLLED,
+    EventType::MOUSE_ENTERED,
+    EventType::MOUSE_EXITED,
+    EventType::WINDOW_RESIZE,
+    EventType::WINDOW_MINIMIZED,
+    EventType::WINDOW_MAXIMIZED,
+    EventType::WINDOW_RESTORED,
+    EventType::WINDOW_MOVED,
+    EventType::WINDOW_FOCUSED,
+    EventType::WINDOW_CLOSE,
+    EventType::FRAMEBUFFER_RESIZE,
+    EventType::CONTENT_SCALE_CHANGED,
+    EventType::FILE_DROP,
+    EventType::CONTROLLER_CONNECTED,
+    EventType::CONTROLLER_DISCONNECTED,
+    EventType::APP_UPDATE,
+    EventType::APP_RENDER,
+};
+
+// NOTE: Indexed by GetBuiltinEventIndex(), the extra entry covers custom ids
+inline constexpr std::array<std::string_view, BUILTIN_EVENT_COUNT + 1> BUILTIN_EVENT_NAMES = {
+    "KeyPressed",
+    "KeyReleased",
+    "KeyTyped",
+    "MouseButtonPressed",
+    "MouseButtonReleased",
+    "MouseMoved",
+    "MouseScrolled",
+    "MouseEntered",
+    "MouseExited",
+    "WindowResize",
+    "WindowMinimized",
+    "WindowMaximized",
+    "WindowRestored",
+    "WindowMoved",
+    "WindowFocused",
+    "WindowClose",
+    "FramebufferResize",
+    "ContentScaleChanged",
+    "FileDrop",
+    "ControllerConnected",
+    "ControllerDisconnected",
+    "Update",
+    "Render",
+    "Custom",
+};
+
+inline constexpr uint32_t INVALID_EVENT_TYPE_INDEX = UINT32_MAX;
+
+// NOTE: Dense index over every event type, built-in types first and custom types after them in registration order.
+// Array-indexed tables sized by GetEventTypeCount() use it in place of hash maps. Ids that belong to no type map to
+// INVALID_EVENT_TYPE_INDEX
+[[nodiscard]] constexpr uint32_t GetEventTypeIndex(uint32_t typeId) noexcept
 {
-    static uint32_t s_NextId = static_cast<uint32_t>(EventType::CUSTOM_START);
-    return s_NextId++;
+    constexpr auto customStart = static_cast<uint32_t>(EventType::CUSTOM_START);
+
+    if (typeId >= customStart)
+    {
+        return typeId <= MAX_EVENT_TYPE_ID ? BUILTIN_EVENT_COUNT + typeId - customStart : INVALID_EVENT_TYPE_INDEX;
+    }
+
+    const uint32_t index = GetBuiltinEventIndex(typeId);
+    return index < BUILTIN_EVENT_COUNT ? index : INVALID_EVENT_TYPE_INDEX;
+}
+
+// NOTE: Inverse of GetEventTypeIndex() for valid indices
+[[nodiscard]] constexpr uint32_t GetEventTypeIdFromIndex(uint32_t index) noexcept
+{
+    if (index < BUILTIN_EVENT_COUNT)
+    {
+        return static_cast<uint32_t>(BUILTIN_EVENT_TYPES[index]);
+    }
+
+    return static_cast<uint32_t>(EventType::CUSTOM_START) + index - BUILTIN_EVENT_COUNT;
 }
 
 } // namespace detail
 
+// NOTE: Number of custom event types that have been assigned an id so far
+[[nodiscard]] uint32_t GetCustomEventTypeCount() noexcept;
+
+// NOTE: Built-in plus custom event types, the size of a table indexed by detail::GetEventTypeIndex()
+[[nodiscard]] inline uint32_t GetEventTypeCount() noexcept
+{
+    return detail::BUILTIN_EVENT_COUNT + GetCustomEventTypeCount();
+}
+
+// NOTE: Name of a built-in event type without the Event suffix. Every custom type is reported as "Custom"
+[[nodiscard]] constexpr std::string_view GetEventTypeName(uint32_t typeId) noexcept
+{
+    if (typeId == static_cast<uint32_t>(EventType::NONE))
+    {
+        return "None";
+    }
+
+    return detail::BUILTIN_EVENT_NAMES[detail::GetBuiltinEventIndex(typeId)];
+}
+
 template <typename T> struct EventTypeId
 {
     static uint32_t Get() noexcept
@@ -219,29 +528,312 @@ template <typename T> struct EventTypeId
     }
 };
 
+// NOTE: Assigns ids to the given custom event types in order. Registering every custom type once at startup, before
+// other threads dispatch, keeps ids stable between runs and lets tables indexed by type be sized once
+template <typename... Ts> void RegisterEventTypes() noexcept
+{
+    (static_cast<void>(EventTypeId<Ts>::Get()), ...);
+}
+
+namespace detail
+{
+
+// NOTE: Extracts the event parameter type of a free or member function taking a single event reference
+template <typename F> struct DelegateTraits;
+
+template <typename R, typename E, bool NE> struct DelegateTraits<R (*)(E &) noexcept(NE)>
+{
+    using EventType = E;
+};
+
+template <typename R, typename C, typename E, bool NE> struct DelegateTraits<R (C::*)(E &) noexcept(NE)>
+{
+    using ObjectType = C;
+    using EventType = E;
+};
+
+template <typename R, typename C, typename E, bool NE> struct DelegateTraits<R (C::*)(E &) const noexcept(NE)>
+{
+    using ObjectType = const C;
+    using EventType = E;
+};
+
+// NOTE: Type-erased callback of a listener created with EventListener::ForBatch<T>, receives the events as an array
+using BatchCallback = std::function<void(const void *pEvents, size_t count)>;
+
+} // namespace detail
+
+// NOTE: Object pointer plus function pointer. Never allocates, is trivially copyable and does not own the object.
+// Functions taking a derived event type should only be bound to listeners created with EventListener::For<T>
+class EventDelegate
+{
+  public:
+    constexpr EventDelegate() noexcept = default;
+
+    template <auto Function, typename T> [[nodiscard]] static constexpr EventDelegate Bind(T *pObject) noexcept
+    {
+        using Traits = detail::DelegateTraits<decltype(Function)>;
+        static_assert(std::is_base_of_v<Event, typename Traits::EventType>, "Delegate must take an event reference");
+        static_assert(std::is_convertible_v<T *, typename Traits::ObjectType *>, "Object does not match function");
+
+        EventDelegate delegate;
+        delegate.m_pObject = const_cast<void *>(static_cast<const void *>(pObject));
+        delegate.m_pFunction = [](void *pTarget, Event &event)
+        {
+            auto *pTyped = static_cast<typename Traits::ObjectType *>(pTarget);
+            (pTyped->*Function)(static_cast<typename Traits::EventType &>(event));
+        };
+        return delegate;
+    }
+
+    template <auto Function> [[nodiscard]] static constexpr EventDelegate Bind() noexcept
+    {
+        using Traits = detail::DelegateTraits<decltype(Function)>;
+        static_assert(std::is_base_of_v<Event, typename Traits::EventType>, "Delegate must take an event reference");
+
+        EventDelegate delegate;
+        delegate.m_pFunction = []([[maybe_unused]] void *pTarget, Event &event)
+        { Function(static_cast<typename Traits::EventType &>(event)); };
+        return delegate;
+    }
+
+    void operator()(Event &event) const
+    {
+        m_pFunction(m_pObject, event);
+    }
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return m_pFunction != nullptr;
+    }
+
+  private:
+    using Thunk = void (*)(void *, Event &);
+
+    void *m_pObject = nullptr;
+    Thunk m_pFunction = nullptr;
+};
+
+// NOTE: Generation-checked reference to a listener slot inside the EventManager
+struct EventListenerHandle
+{
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    uint32_t Index = INVALID_INDEX;
+    uint32_t Generation = 0;
+
+    [[nodiscard]] constexpr bool IsValid() const noexcept
+    {
+        return Index != INVALID_INDEX;
+    }
+};
+
+namespace detail
+{
+
+// NOTE: Keeps the last event a trailing throttle dropped in the throttle's EventStorage and hands it to the listener
+// later. Delivering moves the event out first, so the callback may dispatch into the same listener
+struct TrailingEventOps
+{
+    uint32_t (*pGetTypeId)() noexcept;
+    void (*pStore)(EventStorage &storage, const Event &event);
+    void (*pDeliver)(EventStorage &storage, EventDelegate delegate, const std::function<void(Event &)> &function);
+};
+
+template <typename T>
+inline constexpr TrailingEventOps TRAILING_EVENT_OPS = {
+    .pGetTypeId = &EventTypeId<T>::Get,
+    .pStore = [](EventStorage &storage, const Event &event) { storage.Emplace<T>(static_cast<const T &>(event)); },
+    .pDeliver =
+        [](EventStorage &storage, EventDelegate delegate, const std::function<void(Event &)> &function)
+    {
+        T event = storage.Take<T>();
+
+        if (delegate)
+        {
+            delegate(event);
+        }
+        else
+        {
+            function(event);
+        }
+    },
+};
+
+} // namespace detail
+
+// NOTE: Filter the bus applies before a listener's callback runs, so a dropped event costs no call. Sampling passes
+// every Nth event that reaches the listener, the rate limit then passes at most one of those per interval. A trailing
+// throttle keeps the last event the rate limit dropped and delivers it on the first Flush() after the interval ends,
+// unless a newer event got through first. Throttled listeners assume one thread dispatches on the bus at a time
+struct EventThrottle
+{
+    std::chrono::nanoseconds MinInterval{ 0 }; // NOTE: Zero disables the rate limit
+    uint32_t SampleEvery = 1;
+    const detail::TrailingEventOps *pTrailing = nullptr; // NOTE: Set through Trailing<T>()
+
+    [[nodiscard]] static constexpr EventThrottle MaxRate(std::chrono::nanoseconds minInterval) noexcept
+    {
+        return EventThrottle{ .MinInterval = minInterval };
+    }
+
+    [[nodiscard]] static constexpr EventThrottle Sample(uint32_t every) noexcept
+    {
+        return EventThrottle{ .SampleEvery = every };
+    }
+
+    // NOTE: Only valid on listeners created with EventListener::For<T>, the dropped event is stored as a T
+    template <typename T> [[nodiscard]] static constexpr EventThrottle Trailing(std::chrono::nanoseconds minInterval)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "Throttled type must derive from ae::Event");
+        static_assert(sizeof(T) <= MAX_INLINE_EVENT_SIZE, "Throttled event is too large for trailing delivery");
+        static_assert(alignof(T) <= MAX_INLINE_EVENT_ALIGNMENT, "Throttled event is over-aligned");
+        static_assert(std::is_copy_constructible_v<T>, "Throttled event must be copyable for trailing delivery");
+
+        return EventThrottle{ .MinInterval = minInterval, .pTrailing = &detail::TRAILING_EVENT_OPS<T> };
+    }
+
+    [[nodiscard]] constexpr bool IsActive() const noexcept
+    {
+        return MinInterval.count() > 0 || SampleEvery > 1;
+    }
+};
+
 class EventListener
 {
-    friend class EventManager;
+  public:
+    static constexpr int32_t DEFAULT_PRIORITY = 0;
 
   public:
     EventListener();
     explicit EventListener(std::function<void(Event &)> callback);
+    EventListener(uint32_t typeId, std::function<void(Event &)> callback);
+    explicit EventListener(EventDelegate delegate);
+    EventListener(uint32_t typeId, EventDelegate delegate);
+
+    // NOTE: Register on the given bus instead of the global one
+    EventListener(EventBus &bus, std::function<void(Event &)> callback);
+    EventListener(EventBus &bus, uint32_t typeId, std::function<void(Event &)> callback);
+    EventListener(EventBus &bus, EventDelegate delegate);
+    EventListener(EventBus &bus, uint32_t typeId, EventDelegate delegate);
+
     EventListener(const EventListener &) = delete;
     EventListener &operator=(const EventListener &) = delete;
     EventListener(EventListener &&other) noexcept;
     EventListener &operator=(EventListener &&other) noexcept;
     ~EventListener();
 
+    // NOTE: Creates a listener that only receives events of type T. The callback may take T & or Event &
+    template <typename T, typename F> [[nodiscard]] static EventListener For(F &&callback)
+    {
+        return For<T>(GetGlobalBus(), std::forward<F>(callback));
+    }
+
+    template <typename T, typename F> [[nodiscard]] static EventListener For(EventBus &bus, F &&callback)
+    {
+        if constexpr (std::is_same_v<std::remove_cvref_t<F>, EventDelegate>)
+        {
+            return EventListener(bus, EventTypeId<T>::Get(), callback);
+        }
+        else
+        {
+            return EventListener(bus, EventTypeId<T>::Get(),
+                                 [callback = std::forward<F>(callback)](Event &event) mutable
+                                 { callback(static_cast<T &>(event)); });
+        }
+    }
+
+    // NOTE: Creates a listener that receives events of type T in batches from EventManager::DispatchBatch<T>(), one
+    // call per batch with a std::span<const T>. It receives no single events and cannot consume, so it runs for every
+    // batch whatever the propagation mode
+    template <typename T, typename F> [[nodiscard]] static EventListener ForBatch(F &&callback)
+    {
+        return ForBatch<T>(GetGlobalBus(), std::forward<F>(callback));
+    }
+
+    template <typename T, typename F> [[nodiscard]] static EventListener ForBatch(EventBus &bus, F &&callback)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "Batched type must derive from ae::Event");
+
+        return EventListener(bus, EventTypeId<T>::Get(),
+                             detail::BatchCallback(
+                                 [callback = std::forward<F>(callback)](const void *pEvents, size_t count) mutable
+                                 { callback(std::span<const T>(static_cast<const T *>(pEvents), count)); }));
+    }
+
+    // NOTE: Creates a listener that only receives events in at least one of the given categories
+    [[nodiscard]] static EventListener ForCategories(EventCategoryWrapper categories,
+                                                     std::function<void(Event &)> callback);
+    [[nodiscard]] static EventListener ForCategories(EventBus &bus, EventCategoryWrapper categories,
+                                                     std::function<void(Event &)> callback);
+
     void SetCallback(std::function<void(Event &)> callback);
 
-  private:
-    [[nodiscard]] const std::function<void(Event &)> &GetCallback() const noexcept
+    // NOTE: Replaces any std::function callback, the EventManager then calls the delegate directly
+    void SetCallback(EventDelegate delegate);
+
+    void SetCategoryMask(EventCategoryWrapper categories);
+
+    // NOTE: Listeners with a higher priority run first, listeners with equal priority in the order they were added.
+    // Typed and catch-all listeners share one order
+    void SetPriority(int32_t priority);
+
+    [[nodiscard]] int32_t GetPriority() const noexcept
+    {
+        return m_Priority;
+    }
+
+    // NOTE: Setting a throttle restarts it, EventThrottle() removes it
+    void SetThrottle(const EventThrottle &throttle);
+
+    [[nodiscard]] const EventThrottle &GetThrottle() const noexcept
+    {
+        return m_Throttle;
+    }
+
+    // NOTE: EventType::NONE means the listener receives every event
+    [[nodiscard]] uint32_t GetTypeId() const noexcept
     {
-        return m_Callback;
+        return m_TypeId;
+    }
+
+    // NOTE: The default mask has every bit set and also accepts uncategorized events
+    [[nodiscard]] EventCategoryWrapper GetCategoryMask() const noexcept
+    {
+        return m_CategoryMask;
+    }
+
+    [[nodiscard]] EventListenerHandle GetHandle() const noexcept
+    {
+        return m_Handle;
+    }
+
+    [[nodiscard]] bool IsBatch() const noexcept
+    {
+        return m_Batch;
+    }
+
+    [[nodiscard]] EventBus &GetBus() const noexcept
+    {
+        return *m_pBus;
     }
 
   private:
-    std::function<void(Event &)> m_Callback;
+    EventListener(EventBus &bus, uint32_t typeId, EventCategoryWrapper categories,
+                  std::function<void(Event &)> callback);
+    EventListener(EventBus &bus, uint32_t typeId, detail::BatchCallback callback);
+
+    // NOTE: EventManager::Get(), which is not declared here
+    [[nodiscard]] static EventBus &GetGlobalBus() noexcept;
+
+  private:
+    EventBus *m_pBus;
+    EventListenerHandle m_Handle;
+    uint32_t m_TypeId;
+    int32_t m_Priority = DEFAULT_PRIORITY;
+    EventThrottle m_Throttle;
+    EventCategoryWrapper m_CategoryMask;
+    bool m_Batch = false;
 };
 
 // Key Events
@@ -561,26 +1153,33 @@ class ContentScaleChangedEvent final : public Event
     float m_YScale;
 };
 
+// NOTE: The event only views the paths, the caller owns them. For queued events allocate the paths with
+// EventManager::GetFrameArena() so they stay valid until the event has been flushed
 class FileDropEvent final : public Event
 {
   public:
-    explicit FileDropEvent(std::vector<std::string> paths) noexcept
-        : Event(static_cast<uint32_t>(EventType::FILE_DROP), EventCategory::WINDOW), m_Paths(std::move(paths))
+    explicit constexpr FileDropEvent(std::span<const std::string_view> paths) noexcept
+        : Event(static_cast<uint32_t>(EventType::FILE_DROP), EventCategory::WINDOW), m_Paths(paths)
     {
     }
 
-    [[nodiscard]] const std::vector<std::string> &GetPaths() const noexcept
+    [[nodiscard]] constexpr std::span<const std::string_view> GetPaths() const noexcept
     {
         return m_Paths;
     }
 
-    [[nodiscard]] size_t GetCount() const noexcept
+    [[nodiscard]] constexpr size_t GetCount() const noexcept
     {
         return m_Paths.size();
     }
 
   private:
-    std::vector<std::string> m_Paths;
+    std::span<const std::string_view> m_Paths;
+};
+
+template <> struct EventPayloadTraits<FileDropEvent>
+{
+    static constexpr bool HAS_EXTERNAL_PAYLOAD = true;
 };
 
 // Controller Events
@@ -836,4 +1435,20 @@ template <> struct EventTypeId<RenderEvent>
     }
 };
 
+namespace detail
+{
+
+template <typename... Ts> inline constexpr bool ARE_POD_EVENTS = (PodEvent<Ts> && ...);
+
+} // namespace detail
+
+static_assert(detail::ARE_POD_EVENTS<KeyPressedEvent, KeyReleasedEvent, KeyTypedEvent, MouseButtonPressedEvent,
+                                     MouseButtonReleasedEvent, MouseMovedEvent, MouseScrolledEvent, MouseEnteredEvent,
+                                     MouseExitedEvent, WindowResizeEvent, WindowMinimizedEvent, WindowMaximizedEvent,
+                                     WindowRestoredEvent, WindowMovedEvent, WindowFocusedEvent, WindowCloseEvent,
+                                     FramebufferResizeEvent, ContentScaleChangedEvent, ControllerConnectedEvent,
+                                     ControllerDisconnectedEvent, UpdateEvent, RenderEvent>,
+              "Built-in events must stay PodEvents");
+static_assert(!PodEvent<FileDropEvent>, "FileDropEvent points at paths it does not own");
+
 } // namespace ae
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "ConcurrentEventQueue.h"
+#include "Event.h"
+#include "EventQueue.h"
+#include "EventScheduler.h"
+#include "FrameArena.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+namespace detail
+{
+class EventWaitRegistry;
+} // namespace detail
+
+// NOTE: Listener registry with its own deferred and posted queues. EventManager::Get() is the global bus that
+// listeners and Event::Dispatch() use by default. Further buses shard traffic by subsystem, so each dispatch only
+// walks the listeners of its own bus. Listeners must be destroyed before the bus they are registered on
+class EventBus
+{
+    friend class Event;
+    friend class EventListener;
+
+  public:
+    // NOTE: Priorities of the listeners the library registers itself, above anything a user listener should need.
+    // Observers go first and never consume, so a listener that consumes with EventPropagation::STOP_ON_CONSUME cannot
+    // hide events from a recording or another process. Input state follows, so every later listener, including a
+    // coroutine resumed by the same event, polls the state the event left behind. Timers fire before the frame's
+    // update listeners and waiting coroutines
+    static constexpr int32_t OBSERVER_PRIORITY = INT32_MAX;
+    static constexpr int32_t INPUT_STATE_PRIORITY = INT32_MAX - 1;
+    static constexpr int32_t TIMER_PRIORITY = INT32_MAX - 2;
+    static constexpr int32_t COROUTINE_PRIORITY = INT32_MAX - 3;
+
+  public:
+    explicit EventBus(std::string name = "Unnamed");
+    EventBus(const EventBus &) = delete;
+    EventBus &operator=(const EventBus &) = delete;
+    EventBus(EventBus &&) = delete;
+    EventBus &operator=(EventBus &&) = delete;
+    ~EventBus();
+
+    // NOTE: One bus per thread, created on first use and destroyed when the thread exits. Lets a worker dispatch
+    // and flush its own events without touching the listeners of other threads
+    [[nodiscard]] static EventBus &GetThreadLocal();
+
+    [[nodiscard]] const std::string &GetName() const noexcept
+    {
+        return m_Name;
+    }
+
+    // NOTE: Dispatches the event immediately on this bus, like Event::Dispatch() does on the global bus
+    void Dispatch(Event &event, EventPropagation propagation = EventPropagation::ALL_LISTENERS) const
+    {
+        DispatchEvent(event, propagation);
+    }
+
+    // NOTE: Constructs the event in the deferred queue, it is dispatched on the next Flush()
+    template <typename T, typename... Args> void Enqueue(Args &&...args)
+    {
+        m_Queue.Emplace<T>(std::forward<Args>(args)...);
+    }
+
+    // NOTE: Thread-safe and lock-free, may be called from any thread. Returns false if the post queue is full.
+    // Posted events are dispatched on the thread that calls Flush()
+    template <typename T, typename... Args> bool Post(Args &&...args)
+    {
+        return m_PostQueue.TryEmplace<T>(std::forward<Args>(args)...);
+    }
+
+    // NOTE: Constructs the event now and delivers it once the delay has passed. Time advances with the delta time
+    // of each UpdateEvent dispatched on this bus, see EventScheduler
+    template <typename T, typename... Args> TimerHandle Schedule(std::chrono::nanoseconds delay, Args &&...args)
+    {
+        EnableTimers();
+        return m_Scheduler.Schedule<T>(delay, std::chrono::nanoseconds(0), std::forward<Args>(args)...);
+    }
+
+    // NOTE: Delivers a copy of the event every interval until the timer is cancelled
+    template <typename T, typename... Args>
+    TimerHandle SchedulePeriodic(std::chrono::nanoseconds interval, Args &&...args)
+    {
+        EnableTimers();
+        return m_Scheduler.Schedule<T>(interval, interval, std::forward<Args>(args)...);
+    }
+
+    bool CancelTimer(TimerHandle handle) noexcept
+    {
+        return m_Scheduler.Cancel(handle);
+    }
+
+    [[nodiscard]] EventScheduler &GetScheduler() noexcept
+    {
+        return m_Scheduler;
+    }
+
+    // NOTE: Dispatches a frame's worth of one event type at once. Listeners created with EventListener::ForBatch<T>()
+    // receive the whole span in one call, in priority order, before the per-event listeners see the events one by
+    // one. The per-event pass dispatches copies and is skipped when no per-event listener would receive T
+    template <typename T> void DispatchBatch(std::span<const T> events,
+                                             EventPropagation propagation = EventPropagation::ALL_LISTENERS)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "Batched type must derive from ae::Event");
+        static_assert(std::is_copy_constructible_v<T>, "Batched event must be copy constructible");
+
+        if (events.empty() || !DispatchToBatchListeners(EventTypeId<T>::Get(), events.data(), events.size()))
+        {
+            return;
+        }
+
+        for (const T &event : events)
+        {
+            T copy = event;
+            DispatchEvent(copy, propagation);
+        }
+    }
+
+    // NOTE: Dispatches all posted events, then all queued events, in one batch. Intended to be called once per frame
+    // from the main thread. A flush from inside a listener it dispatches is ignored
+    void Flush(EventPropagation propagation = EventPropagation::ALL_LISTENERS);
+
+    // NOTE: Arena for payloads of events enqueued this frame, such as FileDropEvent paths. It is reset once the
+    // events enqueued alongside it have been flushed. Not thread-safe, posted events must not use it
+    [[nodiscard]] FrameArena &GetFrameArena() noexcept
+    {
+        return m_FrameArenas[m_FrameArenaIndex];
+    }
+
+    [[nodiscard]] size_t GetQueuedEventCount() const noexcept
+    {
+        return m_Queue.GetCount();
+    }
+
+    [[nodiscard]] ConcurrentEventQueueStats GetPostQueueStats() const noexcept
+    {
+        return m_PostQueue.GetStats();
+    }
+
+    [[nodiscard]] bool IsListenerValid(EventListenerHandle handle) const noexcept;
+
+    // NOTE: Coroutines suspended in NextEvent() on this bus, created on first use. Defined in EventCoroutine.h
+    [[nodiscard]] detail::EventWaitRegistry &GetWaitRegistry();
+
+  private:
+    static constexpr uint32_t SLOT_PAGE_SIZE = 1024;
+    static constexpr uint32_t MAX_SLOT_PAGES = 4096;
+
+    struct ThrottleState;
+
+    // NOTE: The parts of a listener that are not trivially copyable. Immutable once published, a change replaces the
+    // whole object and retires the old one with the table that still points at it
+    struct ListenerCallbacks
+    {
+        std::function<void(Event &)> Function;
+        detail::BatchCallback BatchFunction;
+        std::shared_ptr<ThrottleState> pThrottle;
+    };
+
+    // NOTE: Sparse side of the slot map, handles index into this and stay stable across swap-and-pop. Only the
+    // generation is read during dispatch, the rest belongs to writers
+    struct ListenerSlot
+    {
+        std::atomic<uint32_t> Generation = 0;
+        uint32_t BucketIndex = 0;
+        uint32_t DenseIndex = 0;
+        std::unique_ptr<const ListenerCallbacks> pCallbacks; // NOTE: nullptr for plain delegate listeners
+    };
+
+    // NOTE: Slots live in pages that never move, so a dispatch can read generations while a listener is added
+    struct SlotPage
+    {
+        std::array<ListenerSlot, SLOT_PAGE_SIZE> Slots;
+    };
+
+    // NOTE: Mutable state of a throttled listener. Its callbacks point at it, and retired callbacks keep it alive until
+    // no dispatch reads it
+    struct ThrottleState
+    {
+        explicit ThrottleState(const EventThrottle &throttle) noexcept : Throttle(throttle)
+        {
+        }
+
+        EventThrottle Throttle;
+        EventStorage Trailing; // NOTE: The last event a trailing throttle dropped
+        std::chrono::steady_clock::time_point LastDelivery;
+        uint32_t SampleCounter = 0;
+        bool HasDelivered = false;
+        bool TrailingQueued = false; // NOTE: Whether the bus holds it in m_TrailingThrottles
+    };
+
+    // NOTE: Dense side, all arrays share the same index and are sorted by descending priority. Masks are packed so
+    // the filter pass only touches them. A listener uses either its delegate or the std::function in its callbacks,
+    // the delegate is checked first. Batch listeners only have a batch function and a zero mask, so single events skip
+    // them. Every element is trivially copyable, so copying a bucket for a write is a plain memory copy
+    struct ListenerBucket
+    {
+        std::vector<int32_t> Priorities;
+        std::vector<uint8_t> Masks;
+        std::vector<EventDelegate> Delegates;
+        std::vector<const ListenerCallbacks *> Callbacks; // NOTE: Owned by the slot, see ListenerSlot::pCallbacks
+        std::vector<EventListenerHandle> Handles;
+        uint32_t BatchCount = 0;
+        uint32_t ThrottleCount = 0;
+    };
+
+    // NOTE: Immutable once published. Tables share their buckets, so a write only copies the bucket it changes
+    struct DispatchTable
+    {
+        // NOTE: Bucket 0 holds catch-all listeners, bucket i + 1 the listeners of the type with dense index i. Types
+        // without listeners have no bucket
+        std::vector<std::shared_ptr<const ListenerBucket>> Buckets;
+    };
+
+    // NOTE: A replaced table, with the callbacks only it still points at, and the reader epoch it was replaced in
+    struct RetiredTable
+    {
+        std::unique_ptr<const DispatchTable> pTable;
+        std::unique_ptr<const ListenerCallbacks> pCallbacks;
+        uint32_t Epoch = 0;
+    };
+
+  protected:
+    // NOTE: Only the global bus records instrumentation, which is single-threaded
+    EventBus(std::string name, bool instrumented);
+
+  private:
+    [[nodiscard]] EventListenerHandle AddListener(uint32_t typeId, EventCategoryWrapper categories,
+                                                  std::function<void(Event &)> callback);
+    [[nodiscard]] EventListenerHandle AddListener(uint32_t typeId, EventCategoryWrapper categories,
+                                                  EventDelegate delegate);
+    [[nodiscard]] EventListenerHandle AddListener(uint32_t typeId, EventCategoryWrapper categories,
+                                                  EventDelegate delegate, std::function<void(Event &)> function,
+                                                  detail::BatchCallback batchFunction);
+    [[nodiscard]] EventListenerHandle AddBatchListener(uint32_t typeId, detail::BatchCallback callback);
+    void RemoveListener(EventListenerHandle handle);
+
+    void SetListenerCallback(EventListenerHandle handle, std::function<void(Event &)> callback);
+    void SetListenerCallback(EventListenerHandle handle, EventDelegate delegate);
+    void SetListenerCategoryMask(EventListenerHandle handle, EventCategoryWrapper categories);
+    void SetListenerPriority(EventListenerHandle handle, int32_t priority);
+    void SetListenerThrottle(EventListenerHandle handle, const EventThrottle &throttle);
+
+    void DispatchEvent(Event &event, EventPropagation propagation) const;
+
+    // NOTE: Returns false if no per-event listener would receive events of the type
+    [[nodiscard]] bool DispatchToBatchListeners(uint32_t typeId, const void *pEvents, size_t count) const;
+
+    template <EventPropagation Propagation> void DispatchQueuedEvent(Event &event) const
+    {
+        DispatchEvent(event, Propagation);
+    }
+
+    // NOTE: Registers the UpdateEvent listener that drives the scheduler on the first timer, so buses without timers
+    // do not have it
+    void EnableTimers();
+
+    void OnUpdate(UpdateEvent &event);
+
+    [[nodiscard]] ListenerSlot &GetSlot(uint32_t index) const noexcept
+    {
+        return m_pSlotPages[index / SLOT_PAGE_SIZE]->Slots[index % SLOT_PAGE_SIZE];
+    }
+
+    [[nodiscard]] ListenerSlot *FindSlot(EventListenerHandle handle) noexcept;
+
+    // NOTE: Writers hold m_WriteMutex, copy the current table, change the copy and publish it
+    [[nodiscard]] std::unique_ptr<DispatchTable> CopyDispatchTable() const;
+
+    [[nodiscard]] static uint32_t GetBucketIndex(DispatchTable &table, uint32_t typeId);
+
+    [[nodiscard]] static ListenerBucket &EditBucket(DispatchTable &table, uint32_t bucketIndex);
+
+    // NOTE: Keep the bucket sorted and the dense indices of the slots behind the changed position up to date
+    uint32_t InsertIntoBucket(ListenerBucket &bucket, int32_t priority, uint8_t mask, EventDelegate delegate,
+                              const ListenerCallbacks *pCallbacks, EventListenerHandle handle);
+    void EraseFromBucket(ListenerBucket &bucket, uint32_t denseIndex);
+    void UpdateDenseIndices(const ListenerBucket &bucket, uint32_t begin);
+
+    // NOTE: Gives the slot new callbacks, or none if they are empty, and returns the old ones to retire
+    [[nodiscard]] static std::unique_ptr<const ListenerCallbacks>
+    ReplaceCallbacks(ListenerSlot &slot, ListenerBucket &bucket, ListenerCallbacks callbacks);
+
+    // NOTE: The callbacks are retired with the replaced table, since only that table may still point at them
+    void PublishDispatchTable(std::unique_ptr<DispatchTable> pTable,
+                              std::unique_ptr<const ListenerCallbacks> pRetiredCallbacks = nullptr);
+
+    void ReclaimDispatchTables();
+
+    [[nodiscard]] static uint8_t GetFilterMask(EventCategoryWrapper categories) noexcept;
+
+    // NOTE: Each returns true if a listener consumed the event
+    template <bool Instrumented>
+    bool DispatchToBuckets(const DispatchTable &table, const ListenerBucket *pTypedBucket, Event &event,
+                           EventPropagation propagation) const;
+
+    template <bool Instrumented>
+    bool DispatchToBucket(const DispatchTable &table, const ListenerBucket &bucket, uint8_t eventBits, Event &event,
+                          EventPropagation propagation) const;
+
+    template <bool Instrumented>
+    bool DispatchToListener(const DispatchTable &table, const ListenerBucket &bucket, size_t index, Event &event,
+                            EventPropagation propagation) const;
+
+    // NOTE: Returns false if the throttle drops the event, keeping a copy of it for a trailing throttle
+    [[nodiscard]] bool PassThrottle(const std::shared_ptr<ThrottleState> &pState, const Event &event) const;
+
+    // NOTE: Delivers the trailing events whose interval has ended, called by Flush()
+    void DeliverTrailingEvents();
+
+  private:
+    std::array<std::unique_ptr<SlotPage>, MAX_SLOT_PAGES> m_pSlotPages;
+    std::atomic<uint32_t> m_SlotCount = 0;
+    std::vector<uint32_t> m_FreeSlots;
+
+    // NOTE: Dispatch reads the table through the atomic pointer and only bumps the reader count of the current epoch,
+    // in the counter picked by its parity. A writer advances the epoch once the other counter has drained, and frees
+    // the tables retired before the current epoch began. Readers that outlive many writes only hold back the tables
+    // retired since they started, however many other threads keep dispatching
+    std::atomic<const DispatchTable *> m_pDispatchTable = nullptr;
+    std::atomic<uint32_t> m_ReaderEpoch = 0;
+    mutable std::array<std::atomic<uint32_t>, 2> m_ActiveReaders = {};
+    std::vector<RetiredTable> m_RetiredTables;
+    std::mutex m_WriteMutex;
+
+    std::string m_Name;
+    bool m_Instrumented = false;
+    std::unique_ptr<detail::EventWaitRegistry> m_pWaitRegistry;
+
+    EventQueue m_Queue;
+    ConcurrentEventQueue m_PostQueue;
+    FrameArena m_FrameArenas[2]; // NOTE: Swapped on flush, like the buffers in EventQueue
+    uint32_t m_FrameArenaIndex = 0;
+    bool m_Flushing = false; // NOTE: Covers the whole of Flush(), posted events and trailing deliveries included
+
+    EventScheduler m_Scheduler;
+    std::optional<EventListener> m_TimerListener;
+
+    // NOTE: Throttles holding a trailing event, filled during dispatch. The second vector is swapped in while they
+    // are delivered, so callbacks can queue new ones without allocating in the steady state
+    mutable std::vector<std::shared_ptr<ThrottleState>> m_TrailingThrottles;
+    std::vector<std::shared_ptr<ThrottleState>> m_DeliveringThrottles;
+};
+} // namespace ae
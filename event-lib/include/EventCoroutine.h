@@ -0,0 +1,253 @@
+#pragma once
+
+#include "Event.h"
+#include "EventManager.h"
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+
+namespace detail
+{
+
+// NOTE: Size-class free lists per thread. Frames up to MAX_POOLED_COROUTINE_FRAME_SIZE are reused, larger ones go to
+// the global allocator. A frame freed on another thread joins that thread's pool
+inline constexpr size_t COROUTINE_FRAME_SIZE_CLASS = 64;
+inline constexpr size_t MAX_POOLED_COROUTINE_FRAME_SIZE = 2048;
+
+[[nodiscard]] void *AllocateCoroutineFrame(size_t size);
+void FreeCoroutineFrame(void *pFrame, size_t size) noexcept;
+
+// NOTE: A suspended NextEvent() awaiter. The awaiter lives in the coroutine frame, so parking allocates nothing
+// beyond the waiter list
+struct EventWaiter
+{
+    std::coroutine_handle<> Handle;
+    void *pAwaiter = nullptr; // NOTE: nullptr once the awaiter was removed while its list was being dispatched
+    bool (*pTryMatch)(void *pAwaiter, Event &event) = nullptr;
+};
+
+// NOTE: Suspended coroutines of one EventBus, indexed by dense event type index. A type gets an internal listener while
+// a coroutine waits for it, so types nobody waits for cost nothing. Like dispatch it is not thread-safe
+class EventWaitRegistry
+{
+  public:
+    explicit EventWaitRegistry(EventBus &bus) noexcept : m_Bus(bus)
+    {
+    }
+
+    EventWaitRegistry(const EventWaitRegistry &) = delete;
+    EventWaitRegistry &operator=(const EventWaitRegistry &) = delete;
+    ~EventWaitRegistry() = default;
+
+    void Add(uint32_t typeId, const EventWaiter &waiter);
+
+    void Remove(uint32_t typeId, const void *pAwaiter) noexcept;
+
+    [[nodiscard]] size_t GetWaiterCount() const noexcept;
+
+  private:
+    struct TypeWaiters
+    {
+        std::vector<EventWaiter> Waiters;
+        std::vector<std::vector<EventWaiter> *> InFlight; // NOTE: Lists taken out by dispatches in progress
+        std::optional<EventListener> Listener;
+    };
+
+  private:
+    void OnEvent(uint32_t typeIndex, Event &event);
+
+  private:
+    EventBus &m_Bus;
+    std::vector<TypeWaiters> m_Types;
+};
+
+struct AnyEvent
+{
+    template <typename T> constexpr bool operator()(const T &) const noexcept
+    {
+        return true;
+    }
+};
+
+} // namespace detail
+
+// NOTE: Coroutine return type for event-driven sequences. The coroutine starts immediately and runs until its first
+// co_await. The task owns the frame, destroying it cancels a suspended coroutine. Tasks must be destroyed before the
+// EventBus they wait on
+class EventTask
+{
+  public:
+    struct promise_type
+    {
+        [[nodiscard]] EventTask get_return_object() noexcept
+        {
+            return EventTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        [[nodiscard]] std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        // NOTE: Keeps the finished frame alive until the task is destroyed, so IsDone() stays valid
+        [[nodiscard]] std::suspend_always final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+
+        [[nodiscard]] static void *operator new(size_t size)
+        {
+            return detail::AllocateCoroutineFrame(size);
+        }
+
+        static void operator delete(void *pFrame, size_t size) noexcept
+        {
+            detail::FreeCoroutineFrame(pFrame, size);
+        }
+    };
+
+  public:
+    EventTask() noexcept = default;
+    EventTask(const EventTask &) = delete;
+    EventTask &operator=(const EventTask &) = delete;
+
+    EventTask(EventTask &&other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr))
+    {
+    }
+
+    EventTask &operator=(EventTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_Handle = std::exchange(other.m_Handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~EventTask()
+    {
+        Reset();
+    }
+
+    [[nodiscard]] bool IsDone() const noexcept
+    {
+        return !m_Handle || m_Handle.done();
+    }
+
+    // NOTE: Destroys the coroutine, a suspended awaiter removes itself from its EventBus
+    void Reset() noexcept
+    {
+        if (m_Handle)
+        {
+            m_Handle.destroy();
+            m_Handle = nullptr;
+        }
+    }
+
+  private:
+    explicit EventTask(std::coroutine_handle<promise_type> handle) noexcept : m_Handle(handle)
+    {
+    }
+
+  private:
+    std::coroutine_handle<promise_type> m_Handle;
+};
+
+// NOTE: Returned by NextEvent(). Resumes the coroutine with a copy of the first event of type T dispatched on the bus
+// that passes the filter
+template <typename T, typename F> class EventAwaiter
+{
+  public:
+    EventAwaiter(EventBus &bus, F filter) : m_Bus(bus), m_Filter(std::move(filter))
+    {
+    }
+
+    EventAwaiter(const EventAwaiter &) = delete;
+    EventAwaiter &operator=(const EventAwaiter &) = delete;
+
+    ~EventAwaiter()
+    {
+        if (m_Waiting)
+        {
+            m_Bus.GetWaitRegistry().Remove(EventTypeId<T>::Get(), this);
+        }
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_Waiting = true;
+        m_Bus.GetWaitRegistry().Add(EventTypeId<T>::Get(), detail::EventWaiter{ .Handle = handle,
+                                                                                .pAwaiter = this,
+                                                                                .pTryMatch = &TryMatch });
+    }
+
+    [[nodiscard]] T await_resume()
+    {
+        return std::move(*m_Event);
+    }
+
+  private:
+    static bool TryMatch(void *pAwaiter, Event &event)
+    {
+        auto &awaiter = *static_cast<EventAwaiter *>(pAwaiter);
+        const T &typedEvent = static_cast<const T &>(event);
+
+        if (!awaiter.m_Filter(typedEvent))
+        {
+            return false;
+        }
+
+        awaiter.m_Event.emplace(typedEvent);
+        awaiter.m_Waiting = false;
+        return true;
+    }
+
+  private:
+    EventBus &m_Bus;
+    F m_Filter;
+    std::optional<T> m_Event;
+    bool m_Waiting = false;
+};
+
+// NOTE: co_await NextEvent<KeyPressedEvent>() suspends until the next key press is dispatched on the global bus. The
+// optional filter takes const T & and returns whether the event resumes the coroutine
+template <typename T, typename F = detail::AnyEvent>
+    requires std::derived_from<T, Event> && std::predicate<F &, const T &>
+[[nodiscard]] EventAwaiter<T, F> NextEvent(F filter = {})
+{
+    return EventAwaiter<T, F>(EventManager::Get(), std::move(filter));
+}
+
+template <typename T, typename F = detail::AnyEvent>
+    requires std::derived_from<T, Event> && std::predicate<F &, const T &>
+[[nodiscard]] EventAwaiter<T, F> NextEvent(EventBus &bus, F filter = {})
+{
+    return EventAwaiter<T, F>(bus, std::move(filter));
+}
+
+} // namespace ae
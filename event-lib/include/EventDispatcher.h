@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Event.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ae
+{
+
+namespace detail
+{
+
+// NOTE: Extracts the event type from a handler taking a single event reference: lambdas, functors and functions
+template <typename F> struct HandlerTraits : HandlerTraits<decltype(&F::operator())>
+{
+};
+
+template <typename R, typename E, bool NE> struct HandlerTraits<R (*)(E &) noexcept(NE)>
+{
+    using EventType = E;
+};
+
+template <typename R, typename C, typename E, bool NE> struct HandlerTraits<R (C::*)(E &) noexcept(NE)>
+{
+    using EventType = E;
+};
+
+template <typename R, typename C, typename E, bool NE> struct HandlerTraits<R (C::*)(E &) const noexcept(NE)>
+{
+    using EventType = E;
+};
+
+// NOTE: Without cv-qualifiers, so a handler taking a const reference maps to the type id of the event itself
+template <typename F>
+using HandlerEventType = std::remove_cv_t<typename HandlerTraits<std::remove_cvref_t<F>>::EventType>;
+
+static_assert(std::is_same_v<HandlerEventType<void (*)(const KeyPressedEvent &)>, KeyPressedEvent>,
+              "Handlers taking a const reference must resolve to the event type");
+
+// NOTE: True if the type id of T is known at compile time, which holds for every built-in event
+template <typename T>
+concept StaticEventTypeId = requires { typename std::integral_constant<uint32_t, EventTypeId<T>::Get()>; };
+
+template <typename T, typename... Ts> inline constexpr bool IS_UNIQUE = (!std::is_same_v<T, Ts> && ...);
+
+template <typename... Ts> struct AllUnique : std::true_type
+{
+};
+
+template <typename T, typename... Ts>
+struct AllUnique<T, Ts...> : std::bool_constant<IS_UNIQUE<T, Ts...> && AllUnique<Ts...>::value>
+{
+};
+
+} // namespace detail
+
+// NOTE: Routes an event to the handler whose parameter type matches, with one table lookup for built-in events
+// instead of a chain of GetTypeId() comparisons and casts. Handlers that return bool consume the event by returning
+// true. Custom event ids are resolved once per handler set rather than on every dispatch
+template <typename... Handlers> class EventDispatcher
+{
+    static_assert(sizeof...(Handlers) > 0, "EventDispatcher needs at least one handler");
+    static_assert(sizeof...(Handlers) < UINT8_MAX, "Too many handlers for EventDispatcher");
+    static_assert(detail::AllUnique<detail::HandlerEventType<Handlers>...>::value,
+                  "Each event type may only have one handler");
+    static_assert((std::is_base_of_v<Event, detail::HandlerEventType<Handlers>> && ...),
+                  "Handlers must take a reference to an event type");
+
+  public:
+    explicit EventDispatcher(Handlers... handlers) : m_Handlers(std::forward<Handlers>(handlers)...) {}
+
+    // NOTE: Returns true if a handler was called
+    bool operator()(Event &event)
+    {
+        const uint32_t typeId = event.GetTypeId();
+        uint8_t index = NO_HANDLER;
+
+        if (typeId < static_cast<uint32_t>(EventType::CUSTOM_START))
+        {
+            index = BUILTIN_TABLE[detail::GetBuiltinEventIndex(typeId)];
+        }
+        else if constexpr (CUSTOM_COUNT > 0)
+        {
+            const auto &customIds = GetCustomIds();
+
+            for (size_t i = 0; i < CUSTOM_COUNT; i++)
+            {
+                if (customIds[i].TypeId == typeId)
+                {
+                    index = customIds[i].HandlerIndex;
+                    break;
+                }
+            }
+        }
+
+        if (index == NO_HANDLER)
+        {
+            return false;
+        }
+
+        THUNKS[index](m_Handlers, event);
+        return true;
+    }
+
+  private:
+    using HandlerTuple = std::tuple<Handlers...>;
+    using Thunk = void (*)(HandlerTuple &, Event &);
+
+    static constexpr uint8_t NO_HANDLER = UINT8_MAX;
+
+    static constexpr size_t CUSTOM_COUNT =
+        (static_cast<size_t>(!detail::StaticEventTypeId<detail::HandlerEventType<Handlers>>) + ...);
+
+    struct CustomEntry
+    {
+        uint32_t TypeId;
+        uint8_t HandlerIndex;
+    };
+
+    template <size_t I> static void Invoke(HandlerTuple &handlers, Event &event)
+    {
+        using Handler = std::tuple_element_t<I, HandlerTuple>;
+        using T = detail::HandlerEventType<Handler>;
+
+        auto &handler = std::get<I>(handlers);
+        auto &typedEvent = static_cast<T &>(event);
+
+        if constexpr (std::is_same_v<std::invoke_result_t<decltype(handler), T &>, bool>)
+        {
+            if (std::invoke(handler, typedEvent))
+            {
+                event.Consume();
+            }
+        }
+        else
+        {
+            std::invoke(handler, typedEvent);
+        }
+    }
+
+    static constexpr std::array<Thunk, sizeof...(Handlers)> THUNKS = []<size_t... Is>(std::index_sequence<Is...>)
+    { return std::array<Thunk, sizeof...(Handlers)>{ &Invoke<Is>... }; }(std::index_sequence_for<Handlers...>());
+
+    // NOTE: One extra entry so ids that are not built-in land on NO_HANDLER without a range check
+    static constexpr std::array<uint8_t, detail::BUILTIN_EVENT_COUNT + 1> BUILTIN_TABLE =
+        []<size_t... Is>(std::index_sequence<Is...>)
+    {
+        std::array<uint8_t, detail::BUILTIN_EVENT_COUNT + 1> table{};
+        table.fill(NO_HANDLER);
+
+        auto add = [&table]<typename T>(std::type_identity<T>, size_t index)
+        {
+            if constexpr (detail::StaticEventTypeId<T>)
+            {
+                table[detail::GetBuiltinEventIndex(EventTypeId<T>::Get())] = static_cast<uint8_t>(index);
+            }
+        };
+
+        (add(std::type_identity<detail::HandlerEventType<Handlers>>(), Is), ...);
+        table[detail::BUILTIN_EVENT_COUNT] = NO_HANDLER;
+        return table;
+    }(std::index_sequence_for<Handlers...>());
+
+    [[nodiscard]] static const std::array<CustomEntry, CUSTOM_COUNT> &GetCustomIds() noexcept
+    {
+        // NOTE: A single guarded static per handler set, instead of one EventTypeId<T>::Get() guard per comparison
+        static const std::array<CustomEntry, CUSTOM_COUNT> s_CustomIds = []<size_t... Is>(std::index_sequence<Is...>)
+        {
+            std::array<CustomEntry, CUSTOM_COUNT> entries{};
+            size_t count = 0;
+
+            auto add = [&entries, &count]<typename T>(std::type_identity<T>, size_t index)
+            {
+                if constexpr (!detail::StaticEventTypeId<T>)
+                {
+                    entries[count++] = CustomEntry{ EventTypeId<T>::Get(), static_cast<uint8_t>(index) };
+                }
+            };
+
+            (add(std::type_identity<detail::HandlerEventType<Handlers>>(), Is), ...);
+            return entries;
+        }(std::index_sequence_for<Handlers...>());
+
+        return s_CustomIds;
+    }
+
+  private:
+    HandlerTuple m_Handlers;
+};
+
+template <typename... Handlers> EventDispatcher(Handlers...) -> EventDispatcher<Handlers...>;
+
+// NOTE: One-shot form of EventDispatcher for use inside Layer::OnEvent or a listener callback
+template <typename... Handlers> bool Handle(Event &event, Handlers &&...handlers)
+{
+    return EventDispatcher<Handlers &&...>(std::forward<Handlers>(handlers)...)(event);
+}
+
+} // namespace ae
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Event.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define AE_HAS_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define AE_HAS_TSC
+#endif
+
+// NOTE: Instrumentation is compiled into Debug and Release and compiled out of Dist. Define
+// AE_DISABLE_EVENT_INSTRUMENTATION to remove it from the other configurations as well
+#if !defined(AE_DIST) && !defined(AE_DISABLE_EVENT_INSTRUMENTATION)
+#define AE_EVENT_INSTRUMENTATION
+#endif
+
+namespace ae
+{
+
+class Layer;
+
+struct EventTypeStats
+{
+    uint32_t TypeId = 0;
+    uint64_t DispatchCount = 0;
+    uint64_t ConsumedCount = 0; // NOTE: Dispatches where at least one listener consumed the event
+    double TotalNs = 0.0;
+    double MaxNs = 0.0;
+};
+
+struct ListenerStats
+{
+    EventListenerHandle Handle;
+    uint32_t TypeId = 0; // NOTE: EventType::NONE for catch-all listeners
+    uint64_t CallCount = 0;
+    uint64_t ConsumedCount = 0;
+    double TotalNs = 0.0;
+    double MaxNs = 0.0;
+};
+
+struct LayerStats
+{
+    std::string Name;
+    uint64_t EventCount = 0;
+    uint64_t ConsumedCount = 0;
+    double TotalNs = 0.0;
+    double MaxNs = 0.0;
+};
+
+// NOTE: Every list is sorted by total time, most expensive first
+struct InstrumentationSnapshot
+{
+    std::vector<EventTypeStats> EventTypes;
+    std::vector<ListenerStats> Listeners;
+    std::vector<LayerStats> Layers;
+};
+
+// NOTE: Converts EventInstrumentation::ReadTimestamp() ticks to nanoseconds by comparing against steady_clock over
+// the time since Start(), so no calibration sleep is needed
+class TimestampCalibration
+{
+  public:
+    void Start() noexcept;
+
+    [[nodiscard]] bool IsStarted() const noexcept
+    {
+        return m_StartTicks != 0;
+    }
+
+    [[nodiscard]] uint64_t GetStartTicks() const noexcept
+    {
+        return m_StartTicks;
+    }
+
+    [[nodiscard]] double GetNanosecondsPerTick() const noexcept;
+
+  private:
+    uint64_t m_StartTicks = 0;
+    std::chrono::steady_clock::time_point m_StartTime;
+};
+
+// NOTE: Opt-in dispatch statistics, disabled until SetEnabled(true). When enabled each probe is two timestamp reads
+// and a counter update. Like EventManager it is not thread-safe and expects dispatch on one thread, though listeners
+// may be added and removed on other threads while it dispatches
+class EventInstrumentation
+{
+    friend class EventBus;
+    friend class LayerStack;
+
+  public:
+    EventInstrumentation(const EventInstrumentation &) = delete;
+    EventInstrumentation &operator=(const EventInstrumentation &) = delete;
+    ~EventInstrumentation() = default;
+
+    [[nodiscard]] static EventInstrumentation &Get() noexcept
+    {
+        static EventInstrumentation s_Instance;
+        return s_Instance;
+    }
+
+    void SetEnabled(bool enabled) noexcept;
+
+    [[nodiscard]] bool IsEnabled() const noexcept
+    {
+        return m_Enabled;
+    }
+
+    void Reset() noexcept;
+
+    [[nodiscard]] InstrumentationSnapshot GetSnapshot() const;
+
+    // NOTE: The TSC on x86, otherwise steady_clock ticks. Converted to nanoseconds in the snapshot
+    [[nodiscard]] static uint64_t ReadTimestamp() noexcept
+    {
+#ifdef AE_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+  private:
+    struct Counters
+    {
+        uint64_t Count = 0;
+        uint64_t ConsumedCount = 0;
+        uint64_t TotalTicks = 0;
+        uint64_t MaxTicks = 0;
+
+        void Add(bool consumed, uint64_t ticks) noexcept
+        {
+            Count++;
+            ConsumedCount += consumed ? 1 : 0;
+            TotalTicks += ticks;
+            MaxTicks = ticks > MaxTicks ? ticks : MaxTicks;
+        }
+    };
+
+    struct ListenerCounters
+    {
+        EventListenerHandle Handle;
+        uint32_t TypeId = 0;
+        Counters Total;
+    };
+
+    // NOTE: Same layout as the slot pages of EventBus. Pages never move, so a listener added on another thread
+    // cannot pull the counters out from under a dispatch that is recording into them
+    static constexpr uint32_t LISTENER_PAGE_SIZE = 1024;
+    static constexpr uint32_t MAX_LISTENER_PAGES = 4096;
+
+    struct ListenerPage
+    {
+        std::array<ListenerCounters, LISTENER_PAGE_SIZE> Listeners;
+    };
+
+    struct LayerCounters
+    {
+        std::string Name;
+        Counters Total;
+    };
+
+  private:
+    EventInstrumentation() = default;
+
+  private:
+    void RecordDispatch(uint32_t typeId, bool consumed, uint64_t ticks);
+
+    void RecordListener(uint32_t slotIndex, bool consumed, uint64_t ticks) noexcept
+    {
+        ListenerPage &page = *m_pListenerPages[slotIndex / LISTENER_PAGE_SIZE];
+        page.Listeners[slotIndex % LISTENER_PAGE_SIZE].Total.Add(consumed, ticks);
+    }
+
+    // NOTE: Looked up before the layer runs, since OnEvent() may remove and delete it
+    [[nodiscard]] uint32_t GetLayerIndex(const Layer *pLayer);
+
+    void RecordLayer(uint32_t layerIndex, bool consumed, uint64_t ticks) noexcept
+    {
+        // NOTE: Reset() may run inside the layer's OnEvent()
+        if (layerIndex < m_Layers.size())
+        {
+            m_Layers[layerIndex].Total.Add(consumed, ticks);
+        }
+    }
+
+    // NOTE: Called by LayerStack when a layer is detached, so a new layer at the same address is looked up by its
+    // own name
+    void OnLayerDetached(const Layer *pLayer) noexcept
+    {
+        m_LayerIndices.erase(pLayer);
+    }
+
+    // NOTE: Called by EventBus whenever a slot is handed out, before the listener is published, so a reused slot
+    // starts from zero and a dispatch never sees a slot without counters
+    void OnListenerAdded(EventListenerHandle handle, uint32_t typeId);
+
+  private:
+    std::vector<Counters> m_EventTypes;        // NOTE: Indexed by detail::GetEventTypeIndex()
+    std::array<std::unique_ptr<ListenerPage>, MAX_LISTENER_PAGES> m_pListenerPages; // NOTE: Indexed like the slots
+    std::vector<LayerCounters> m_Layers;       // NOTE: One per layer name, a layer pushed again adds to its entry
+    std::unordered_map<std::string, uint32_t> m_LayerIndicesByName;
+    std::unordered_map<const Layer *, uint32_t> m_LayerIndices; // NOTE: Attached layers, cleared on detach
+    TimestampCalibration m_Calibration;
+    bool m_Enabled = false;
+};
+
+} // namespace ae
@@ -1,15 +1,12 @@
 #pragma once
 
-#include "Event.h"
-
-#include <unordered_set>
+#include "EventBus.h"
 
 namespace ae
 {
-class EventManager
+// NOTE: The global EventBus. Listeners created without a bus, Event::Dispatch() and the instrumentation all use it
+class EventManager final : public EventBus
 {
-    friend class Event;
-
   public:
     EventManager(const EventManager &) = delete;
     EventManager &operator=(const EventManager &) = delete;
@@ -21,16 +18,9 @@ class EventManager
         return s_Instance;
     }
 
-    void AddListener(EventListener *pListener);
-    void RemoveListener(EventListener *pListener);
-
-  private:
-    EventManager() = default;
-
   private:
-    void DispatchEvent(Event &event) const;
-
-  private:
-    std::unordered_set<EventListener *> m_pListeners;
+    EventManager() : EventBus("Global", true)
+    {
+    }
 };
 } // namespace ae
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "Event.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ae
+{
+
+enum class CoalescePolicy : uint8_t
+{
+    NONE = 0,
+    KEEP_LAST = 1,  // NOTE: A new event overwrites the pending event of the same type
+    ACCUMULATE = 2, // NOTE: A new event is merged into the pending one through EventCoalescing<T>::Accumulate()
+};
+
+// NOTE: Specialize for custom event types to opt in. ACCUMULATE also requires
+// static void Accumulate(T &pending, const T &incoming)
+template <typename T> struct EventCoalescing
+{
+    static constexpr CoalescePolicy Policy = CoalescePolicy::NONE;
+};
+
+template <> struct EventCoalescing<MouseMovedEvent>
+{
+    static constexpr CoalescePolicy Policy = CoalescePolicy::KEEP_LAST;
+};
+
+template <> struct EventCoalescing<MouseScrolledEvent>
+{
+    static constexpr CoalescePolicy Policy = CoalescePolicy::ACCUMULATE;
+
+    static constexpr void Accumulate(MouseScrolledEvent &pending, const MouseScrolledEvent &incoming) noexcept
+    {
+        pending = MouseScrolledEvent(pending.GetXOffset() + incoming.GetXOffset(),
+                                     pending.GetYOffset() + incoming.GetYOffset());
+    }
+};
+
+template <> struct EventCoalescing<WindowResizeEvent>
+{
+    static constexpr CoalescePolicy Policy = CoalescePolicy::KEEP_LAST;
+};
+
+template <> struct EventCoalescing<WindowMovedEvent>
+{
+    static constexpr CoalescePolicy Policy = CoalescePolicy::KEEP_LAST;
+};
+
+template <> struct EventCoalescing<FramebufferResizeEvent>
+{
+    static constexpr CoalescePolicy Policy = CoalescePolicy::KEEP_LAST;
+};
+
+template <> struct EventCoalescing<ContentScaleChangedEvent>
+{
+    static constexpr CoalescePolicy Policy = CoalescePolicy::KEEP_LAST;
+};
+
+// NOTE: Stores events by value in contiguous, type-erased buffers. Events are constructed in place, so pushing
+// does not allocate once the buffers have grown to the per-frame working size. Two buffers are swapped on flush,
+// which lets listeners enqueue new events while a flush is iterating without invalidating the event in flight.
+// Events with a coalescing policy are merged into the pending event of the same type, as long as no event without
+// a policy was pushed in between. The merged event keeps its original position in the queue
+class EventQueue
+{
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 16 * 1024;
+
+    explicit EventQueue(size_t capacity = DEFAULT_CAPACITY);
+    EventQueue(const EventQueue &) = delete;
+    EventQueue &operator=(const EventQueue &) = delete;
+    EventQueue(EventQueue &&) = delete;
+    EventQueue &operator=(EventQueue &&) = delete;
+    ~EventQueue();
+
+    template <typename T, typename... Args> T &Emplace(Args &&...args)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "Queued type must derive from ae::Event");
+        static_assert(alignof(T) <= RECORD_ALIGNMENT, "Queued event is over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<T>, "Queued event must be nothrow move constructible");
+
+        constexpr CoalescePolicy policy = EventCoalescing<T>::Policy;
+
+        if constexpr (policy == CoalescePolicy::NONE)
+        {
+            // NOTE: Acts as a barrier, later events must not be merged across it
+            m_Buffers[m_WriteIndex].CoalesceCount = 0;
+
+            void *pPayload = Allocate(GetRecordSize(sizeof(T)), &RECORD_OPS<T>);
+            return *new (pPayload) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            const uint32_t typeId = EventTypeId<T>::Get();
+
+            if (void *pPending = FindCoalesceTarget(typeId))
+            {
+                T &pending = *static_cast<T *>(pPending);
+
+                if constexpr (policy == CoalescePolicy::KEEP_LAST)
+                {
+                    pending = T(std::forward<Args>(args)...);
+                }
+                else
+                {
+                    EventCoalescing<T>::Accumulate(pending, T(std::forward<Args>(args)...));
+                }
+
+                m_CoalescedCount++;
+                return pending;
+            }
+
+            void *pPayload = Allocate(GetRecordSize(sizeof(T)), &RECORD_OPS<T>);
+            T &event = *new (pPayload) T(std::forward<Args>(args)...);
+            AddCoalesceTarget(typeId, pPayload);
+            return event;
+        }
+    }
+
+    // NOTE: Dispatches every pending event through the delegate in the order they were pushed. Events pushed during
+    // the flush are kept for the next one. Events pushed from inside a dispatch are dispatched in a
+    // detail::DispatchScope, so they still count as caused by that dispatch
+    void Flush(EventDelegate dispatch);
+
+    // NOTE: Destroys every pending event without dispatching it
+    void Clear() noexcept;
+
+    [[nodiscard]] size_t GetCount() const noexcept
+    {
+        return m_Buffers[m_WriteIndex].Count;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept
+    {
+        return GetCount() == 0;
+    }
+
+    [[nodiscard]] bool IsFlushing() const noexcept
+    {
+        return m_Flushing;
+    }
+
+    // NOTE: Total number of events that were merged into a pending event instead of being queued
+    [[nodiscard]] uint64_t GetCoalescedCount() const noexcept
+    {
+        return m_CoalescedCount;
+    }
+
+  private:
+    static constexpr size_t RECORD_ALIGNMENT = alignof(std::max_align_t);
+
+    struct RecordOps
+    {
+        Event &(*pGetEvent)(void *pPayload) noexcept;
+        void (*pRelocate)(void *pDestination, void *pSource) noexcept; // NOTE: Move-constructs, then destroys source
+        void (*pDestroy)(void *pPayload) noexcept;                       // NOTE: nullptr if trivially destructible
+    };
+
+    struct RecordHeader
+    {
+        const RecordOps *pOps;
+        uint32_t Size; // NOTE: Size of the whole record including this header
+        bool Nested;   // NOTE: Queued from inside a dispatch, see detail::GetDispatchDepth()
+    };
+
+    static_assert(sizeof(RecordHeader) <= RECORD_ALIGNMENT);
+
+    static constexpr uint32_t MAX_COALESCE_TARGETS = 8;
+
+    struct CoalesceTarget
+    {
+        uint32_t TypeId;
+        uint32_t Offset; // NOTE: Offsets stay valid when the buffer grows, pointers do not
+    };
+
+    struct Buffer
+    {
+        std::unique_ptr<std::byte[]> pData;
+        size_t Capacity = 0;
+        size_t Size = 0;
+        size_t Count = 0;
+        CoalesceTarget CoalesceTargets[MAX_COALESCE_TARGETS];
+        uint32_t CoalesceCount = 0;
+    };
+
+    template <typename T>
+    static constexpr RecordOps RECORD_OPS = {
+        .pGetEvent = [](void *pPayload) noexcept -> Event & { return *static_cast<T *>(pPayload); },
+        .pRelocate =
+            [](void *pDestination, void *pSource) noexcept
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(pDestination, pSource, sizeof(T));
+            }
+            else
+            {
+                new (pDestination) T(std::move(*static_cast<T *>(pSource)));
+                static_cast<T *>(pSource)->~T();
+            }
+        },
+        .pDestroy = std::is_trivially_destructible_v<T>
+                        ? nullptr
+                        : static_cast<void (*)(void *) noexcept>([](void *pPayload) noexcept
+                                                                 { static_cast<T *>(pPayload)->~T(); }),
+    };
+
+  private:
+    [[nodiscard]] static constexpr size_t GetRecordSize(size_t payloadSize) noexcept
+    {
+        return RECORD_ALIGNMENT + (payloadSize + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    }
+
+    [[nodiscard]] void *Allocate(size_t recordSize, const RecordOps *pOps);
+
+    [[nodiscard]] void *FindCoalesceTarget(uint32_t typeId) noexcept;
+
+    void AddCoalesceTarget(uint32_t typeId, void *pPayload) noexcept;
+
+    static void Grow(Buffer &buffer, size_t requiredSize);
+
+    static void DestroyRecords(Buffer &buffer) noexcept;
+
+  private:
+    Buffer m_Buffers[2];
+    size_t m_InitialCapacity;
+    uint64_t m_CoalescedCount = 0;
+    uint32_t m_WriteIndex = 0;
+    bool m_Flushing = false;
+};
+
+} // namespace ae
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Event.h"
+#include "EventSerialization.h"
+#include "MappedFile.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ae
+{
+
+namespace detail
+{
+
+// NOTE: Type-erased EventSerialization<T> of one recordable type
+struct RecordableEventType
+{
+    std::string_view Name;
+    void (*pWrite)(const Event &event, EventWriter &writer) = nullptr;
+    bool (*pReplay)(EventReader &reader, EventDelegate target) = nullptr;
+};
+
+template <RecordableEvent T> void WriteRecordedEvent(const Event &event, EventWriter &writer)
+{
+    EventSerialization<T>::Write(static_cast<const T &>(event), writer);
+}
+
+template <RecordableEvent T> bool ReplayRecordedEvent(EventReader &reader, EventDelegate target)
+{
+    T event = EventSerialization<T>::Read(reader);
+
+    if (reader.HasFailed())
+    {
+        return false;
+    }
+
+    if (target)
+    {
+        target(event);
+    }
+    else
+    {
+        event.Dispatch();
+    }
+
+    return true;
+}
+
+void RegisterRecordableEventType(uint32_t typeId, const RecordableEventType &type);
+
+// NOTE: Lookups into the registry shared by recordings and SharedEventBridge.h. Registering a type may move the
+// entries, so only the dense type index should be kept
+[[nodiscard]] const RecordableEventType *FindRecordableEventType(uint32_t typeId);
+[[nodiscard]] uint32_t FindRecordableEventTypeIndex(std::string_view name); // NOTE: INVALID_EVENT_TYPE_INDEX if none
+[[nodiscard]] const RecordableEventType &GetRecordableEventType(uint32_t typeIndex);
+
+} // namespace detail
+
+// NOTE: Makes custom event types recordable and replayable, every built-in type already is. Like
+// RegisterEventTypes(), call it at startup before recording or replaying
+template <RecordableEvent... Ts> void RegisterRecordableEvents()
+{
+    (detail::RegisterRecordableEventType(EventTypeId<Ts>::Get(),
+                                         detail::RecordableEventType{ .Name = EventSerialization<Ts>::Name,
+                                                                      .pWrite = &detail::WriteRecordedEvent<Ts>,
+                                                                      .pReplay = &detail::ReplayRecordedEvent<Ts> }),
+     ...);
+}
+
+// NOTE: Writes every event dispatched through the EventManager to a binary file, with nanosecond timestamps relative
+// to Start(). It listens with the highest priority, so events that are consumed early are still recorded. Only events
+// dispatched outside any other dispatch are recorded, see detail::GetDispatchDepth(), since replaying them dispatches
+// everything they cause again. Events posted from other threads count as outermost. Types without an
+// EventSerialization are skipped with a warning. Events a LayerStack receives outside the EventManager are not seen
+class EventRecorder
+{
+  public:
+    static constexpr size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+    EventRecorder() = default;
+    EventRecorder(const EventRecorder &) = delete;
+    EventRecorder &operator=(const EventRecorder &) = delete;
+    ~EventRecorder();
+
+    bool Start(const std::string &path);
+
+    void Stop();
+
+    [[nodiscard]] bool IsRecording() const noexcept
+    {
+        return m_File.is_open();
+    }
+
+    [[nodiscard]] uint64_t GetRecordedEventCount() const noexcept
+    {
+        return m_RecordedEventCount;
+    }
+
+  private:
+    void OnEvent(Event &event);
+
+    void WriteRecordHeader(uint16_t typeIndex, uint64_t timestampNs);
+
+    void FinishRecord(size_t recordOffset);
+
+    void FlushBuffer();
+
+  private:
+    std::ofstream m_File;
+    std::vector<std::byte> m_Buffer;
+    std::vector<uint16_t> m_TypeIndices; // NOTE: Indexed by detail::GetEventTypeIndex(), 0 until the type is written
+    std::vector<bool> m_SkippedTypes;    // NOTE: Types without a serializer, warned about once
+    uint16_t m_NextTypeIndex = 1;
+    uint64_t m_RecordedEventCount = 0;
+    std::chrono::steady_clock::time_point m_StartTime;
+    std::optional<EventListener> m_Listener; // NOTE: Only registered while recording
+};
+
+// NOTE: Streams a recording from a memory-mapped file and dispatches its events. Without a target events go through
+// Event::Dispatch(). A target such as EventDelegate::Bind<&LayerStack::OnEvent>(&layerStack) receives them directly
+class EventReplay
+{
+  public:
+    EventReplay() = default;
+    EventReplay(const EventReplay &) = delete;
+    EventReplay &operator=(const EventReplay &) = delete;
+    ~EventReplay() = default;
+
+    bool Open(const std::string &path);
+
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept
+    {
+        return m_File.IsOpen();
+    }
+
+    [[nodiscard]] bool IsFinished() const noexcept
+    {
+        return m_Offset >= m_File.GetData().size();
+    }
+
+    // NOTE: Restarts from the first event and resets the real-time clock
+    void Rewind() noexcept;
+
+    // NOTE: Dispatches every remaining event back to back. Returns the number of events dispatched
+    size_t ReplayAll(EventDelegate target = EventDelegate());
+
+    // NOTE: Dispatches the events recorded up to the given time after the start of the recording
+    size_t ReplayUntil(uint64_t timestampNs, EventDelegate target = EventDelegate());
+
+    // NOTE: Dispatches the events that are due since the first call after Open() or Rewind(). Call once per frame to
+    // play the recording back at its original speed
+    size_t ReplayRealTime(EventDelegate target = EventDelegate());
+
+  private:
+    struct RecordedType
+    {
+        uint32_t TypeIndex = detail::INVALID_EVENT_TYPE_INDEX; // NOTE: Dense index of the matching registered type
+        bool Warned = false;
+    };
+
+  private:
+    MappedFile m_File;
+    size_t m_Offset = 0;
+    size_t m_FirstRecordOffset = 0;
+    std::vector<RecordedType> m_Types; // NOTE: Indexed by the type index used in the recording
+    std::vector<std::string_view> m_Strings;
+    std::chrono::steady_clock::time_point m_StartTime;
+    bool m_Started = false;
+};
+
+} // namespace ae
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Event.h"
+#include "EventQueue.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+
+enum class TimerDelivery : uint8_t
+{
+    DISPATCH = 0, // NOTE: Fired events are dispatched immediately, from inside the tick
+    ENQUEUE = 1,  // NOTE: Fired events are queued on the bus and dispatched on its next Flush()
+};
+
+// NOTE: Generation-checked reference to a pending timer, stale once the timer has fired or been cancelled
+struct TimerHandle
+{
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    uint32_t Index = INVALID_INDEX;
+    uint32_t Generation = 0;
+
+    [[nodiscard]] constexpr bool IsValid() const noexcept
+    {
+        return Index != INVALID_INDEX;
+    }
+};
+
+// NOTE: Hierarchical timing wheel of delayed and periodic events. Scheduling and cancelling are O(1), and a tick only
+// touches the timers that expire in it, so pending timers cost nothing until they fire. Levels cover 2^8, 2^14, 2^20
+// and 2^26 ticks, longer delays wait in the top level and are placed again as it turns. Not thread-safe, like dispatch
+class EventScheduler
+{
+  public:
+    static constexpr size_t MAX_TIMER_EVENT_SIZE = MAX_INLINE_EVENT_SIZE;
+    static constexpr std::chrono::nanoseconds DEFAULT_RESOLUTION = std::chrono::milliseconds(1);
+
+    EventScheduler(EventDelegate dispatch, EventQueue &queue,
+                   std::chrono::nanoseconds resolution = DEFAULT_RESOLUTION) noexcept;
+    EventScheduler(const EventScheduler &) = delete;
+    EventScheduler &operator=(const EventScheduler &) = delete;
+    ~EventScheduler();
+
+    // NOTE: An interval of zero fires once. Delays are rounded up to whole ticks, and at least one tick
+    template <typename T, typename... Args>
+    TimerHandle Schedule(std::chrono::nanoseconds delay, std::chrono::nanoseconds interval, Args &&...args)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "Scheduled type must derive from ae::Event");
+        static_assert(sizeof(T) <= MAX_TIMER_EVENT_SIZE, "Scheduled event is too large");
+        static_assert(alignof(T) <= MAX_INLINE_EVENT_ALIGNMENT, "Scheduled event is over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<T>, "Scheduled event must be nothrow move constructible");
+
+        const uint32_t nodeIndex = AllocateNode();
+        TimerNode &node = GetNode(nodeIndex);
+        node.Storage.Emplace<T>(std::forward<Args>(args)...);
+        node.pFire = &FireTimer<T>;
+        node.Interval = interval.count() > 0 ? ToTicks(interval) : 0;
+        node.Expires = m_CurrentTick + ToTicks(delay);
+
+        Link(nodeIndex);
+        m_PendingCount++;
+        return TimerHandle{ .Index = nodeIndex, .Generation = node.Generation };
+    }
+
+    // NOTE: Returns false if the timer already fired or was cancelled
+    bool Cancel(TimerHandle handle) noexcept;
+
+    [[nodiscard]] bool IsPending(TimerHandle handle) const noexcept;
+
+    // NOTE: Moves time forward and fires every timer that expires on the way, tick by tick. Timers that expire in the
+    // same tick fire in no particular order
+    void Advance(std::chrono::nanoseconds time);
+
+    // NOTE: Destroys every pending timer without firing it
+    void Clear() noexcept;
+
+    void SetDelivery(TimerDelivery delivery) noexcept
+    {
+        m_Delivery = delivery;
+    }
+
+    [[nodiscard]] TimerDelivery GetDelivery() const noexcept
+    {
+        return m_Delivery;
+    }
+
+    [[nodiscard]] size_t GetPendingCount() const noexcept
+    {
+        return m_PendingCount;
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds GetResolution() const noexcept
+    {
+        return m_Resolution;
+    }
+
+  private:
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+    static constexpr uint32_t NODE_PAGE_SIZE = 256;
+
+    static constexpr uint32_t LOW_LEVEL_BITS = 8;
+    static constexpr uint32_t HIGH_LEVEL_BITS = 6;
+    static constexpr uint32_t HIGH_LEVEL_COUNT = 3;
+    static constexpr uint32_t LOW_LEVEL_SLOTS = 1 << LOW_LEVEL_BITS;
+    static constexpr uint32_t HIGH_LEVEL_SLOTS = 1 << HIGH_LEVEL_BITS;
+    static constexpr uint32_t SLOT_COUNT = LOW_LEVEL_SLOTS + HIGH_LEVEL_COUNT * HIGH_LEVEL_SLOTS;
+    static constexpr uint64_t MAX_TICKS = uint64_t(1) << (LOW_LEVEL_BITS + HIGH_LEVEL_COUNT * HIGH_LEVEL_BITS);
+
+    // NOTE: Nodes live in pages that never move, so the event stored inline stays in place until it fires
+    struct TimerNode
+    {
+        EventStorage Storage;
+
+        // NOTE: FireTimer<T> for the stored type, nullptr while the node is free
+        void (*pFire)(EventScheduler &scheduler, uint32_t nodeIndex, bool periodic) = nullptr;
+
+        uint64_t Expires = 0;
+        uint64_t Interval = 0;
+        uint32_t Prev = INVALID_NODE;
+        uint32_t Next = INVALID_NODE; // NOTE: Also links the free list
+        uint32_t Slot = 0;
+        uint32_t Generation = 0;
+    };
+
+    struct NodePage
+    {
+        std::array<TimerNode, NODE_PAGE_SIZE> Nodes;
+    };
+
+    // NOTE: A periodic timer is linked again before its event is delivered, so a listener can still cancel it
+    template <typename T> static void FireTimer(EventScheduler &scheduler, uint32_t nodeIndex, bool periodic)
+    {
+        TimerNode &node = scheduler.GetNode(nodeIndex);
+
+        if (periodic)
+        {
+            scheduler.Deliver(T(node.Storage.Get<T>()));
+            return;
+        }
+
+        T event = node.Storage.Take<T>();
+        scheduler.FreeNode(nodeIndex);
+        scheduler.Deliver(std::move(event));
+    }
+
+    template <typename T> void Deliver(T &&event)
+    {
+        if (m_Delivery == TimerDelivery::ENQUEUE)
+        {
+            m_Queue.Emplace<T>(std::move(event));
+        }
+        else
+        {
+            m_Dispatch(event);
+        }
+    }
+
+  private:
+    [[nodiscard]] TimerNode &GetNode(uint32_t index) const noexcept
+    {
+        return m_pNodePages[index / NODE_PAGE_SIZE]->Nodes[index % NODE_PAGE_SIZE];
+    }
+
+    [[nodiscard]] uint64_t ToTicks(std::chrono::nanoseconds time) const noexcept;
+
+    [[nodiscard]] uint32_t AllocateNode();
+
+    void FreeNode(uint32_t nodeIndex) noexcept;
+
+    void Link(uint32_t nodeIndex) noexcept;
+
+    void Unlink(uint32_t nodeIndex) noexcept;
+
+    void Tick();
+
+    void Cascade(uint32_t level);
+
+  private:
+    EventDelegate m_Dispatch;
+    EventQueue &m_Queue;
+    std::chrono::nanoseconds m_Resolution;
+    TimerDelivery m_Delivery = TimerDelivery::DISPATCH;
+
+    std::array<uint32_t, SLOT_COUNT> m_SlotHeads;
+    std::vector<std::unique_ptr<NodePage>> m_pNodePages;
+    uint32_t m_FreeNodes = INVALID_NODE;
+    uint32_t m_NodeCount = 0;
+    size_t m_PendingCount = 0;
+
+    uint64_t m_CurrentTick = 0;
+    std::chrono::nanoseconds m_PendingTime{ 0 };
+};
+
+} // namespace ae
@@ -0,0 +1,469 @@
+#pragma once
+
+#include "Event.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ae
+{
+
+// NOTE: Appends values to a recording in host byte order
+class EventWriter
+{
+  public:
+    explicit EventWriter(std::vector<std::byte> &buffer) noexcept : m_Buffer(buffer) {}
+
+    template <typename T> void Write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written directly");
+
+        const size_t offset = m_Buffer.size();
+        m_Buffer.resize(offset + sizeof(T));
+        std::memcpy(m_Buffer.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteString(std::string_view string)
+    {
+        Write(static_cast<uint32_t>(string.size()));
+
+        const size_t offset = m_Buffer.size();
+        m_Buffer.resize(offset + string.size());
+        std::memcpy(m_Buffer.data() + offset, string.data(), string.size());
+    }
+
+    void WriteStrings(std::span<const std::string_view> strings)
+    {
+        Write(static_cast<uint32_t>(strings.size()));
+
+        for (const std::string_view string : strings)
+        {
+            WriteString(string);
+        }
+    }
+
+  private:
+    std::vector<std::byte> &m_Buffer;
+};
+
+// NOTE: Reads one recorded event. Reading past the end of the record returns zeroed values and marks the reader as
+// failed, the event is then dropped instead of dispatched
+class EventReader
+{
+  public:
+    EventReader(std::span<const std::byte> data, std::vector<std::string_view> &strings) noexcept
+        : m_Data(data), m_Strings(strings)
+    {
+    }
+
+    template <typename T> [[nodiscard]] T Read() noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read directly");
+
+        // NOTE: Any byte other than zero reads as true, copying it into a bool directly would be undefined
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            return Read<uint8_t>() != 0;
+        }
+
+        T value{};
+
+        if (!Reserve(sizeof(T)))
+        {
+            return value;
+        }
+
+        std::memcpy(&value, m_Data.data() + m_Offset, sizeof(T));
+        m_Offset += sizeof(T);
+        return value;
+    }
+
+    // NOTE: Points into the recording, valid for as long as the recording stays open
+    [[nodiscard]] std::string_view ReadString() noexcept
+    {
+        const auto length = Read<uint32_t>();
+
+        if (!Reserve(length))
+        {
+            return {};
+        }
+
+        const std::string_view string(reinterpret_cast<const char *>(m_Data.data() + m_Offset), length);
+        m_Offset += length;
+        return string;
+    }
+
+    // NOTE: The returned span is reused by the next event, so it is only valid while the event is dispatched
+    [[nodiscard]] std::span<const std::string_view> ReadStrings()
+    {
+        const auto count = Read<uint32_t>();
+        m_Strings.clear();
+
+        // NOTE: Every string needs at least its length prefix, which bounds the count of a corrupt record
+        if (count > (m_Data.size() - m_Offset) / sizeof(uint32_t))
+        {
+            m_Failed = true;
+            return {};
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            m_Strings.push_back(ReadString());
+        }
+
+        return m_Strings;
+    }
+
+    [[nodiscard]] bool HasFailed() const noexcept
+    {
+        return m_Failed;
+    }
+
+  private:
+    [[nodiscard]] bool Reserve(size_t size) noexcept
+    {
+        if (m_Failed || size > m_Data.size() - m_Offset)
+        {
+            m_Failed = true;
+            return false;
+        }
+
+        return true;
+    }
+
+  private:
+    std::span<const std::byte> m_Data;
+    size_t m_Offset = 0;
+    std::vector<std::string_view> &m_Strings;
+    bool m_Failed = false;
+};
+
+// NOTE: Specialize for custom event types to make them recordable, then register them with
+// RegisterRecordableEvents(). A specialization provides
+//     static constexpr std::string_view Name
+//     static void Write(const T &event, EventWriter &writer)
+//     static T Read(EventReader &reader)
+// Recordings refer to types by name, so they stay valid when custom type ids change between builds
+template <typename T> struct EventSerialization;
+
+template <typename T>
+concept RecordableEvent = std::is_base_of_v<Event, T> && requires(const T &event, EventWriter &writer,
+                                                                   EventReader &reader) {
+    { EventSerialization<T>::Name } -> std::convertible_to<std::string_view>;
+    EventSerialization<T>::Write(event, writer);
+    { EventSerialization<T>::Read(reader) } -> std::same_as<T>;
+};
+
+namespace detail
+{
+
+// NOTE: For events without a payload
+template <typename T> struct EmptyEventSerialization
+{
+    static void Write(const T &, EventWriter &) noexcept {}
+
+    [[nodiscard]] static T Read(EventReader &) noexcept
+    {
+        return T();
+    }
+};
+
+} // namespace detail
+
+template <> struct EventSerialization<KeyPressedEvent>
+{
+    static constexpr std::string_view Name = "KeyPressed";
+
+    static void Write(const KeyPressedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetKeyCode());
+        writer.Write(event.IsRepeat());
+    }
+
+    [[nodiscard]] static KeyPressedEvent Read(EventReader &reader) noexcept
+    {
+        const auto keyCode = reader.Read<int32_t>();
+        return KeyPressedEvent(keyCode, reader.Read<bool>());
+    }
+};
+
+template <> struct EventSerialization<KeyReleasedEvent>
+{
+    static constexpr std::string_view Name = "KeyReleased";
+
+    static void Write(const KeyReleasedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetKeyCode());
+    }
+
+    [[nodiscard]] static KeyReleasedEvent Read(EventReader &reader) noexcept
+    {
+        return KeyReleasedEvent(reader.Read<int32_t>());
+    }
+};
+
+template <> struct EventSerialization<KeyTypedEvent>
+{
+    static constexpr std::string_view Name = "KeyTyped";
+
+    static void Write(const KeyTypedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetCharacter());
+    }
+
+    [[nodiscard]] static KeyTypedEvent Read(EventReader &reader) noexcept
+    {
+        return KeyTypedEvent(reader.Read<uint32_t>());
+    }
+};
+
+template <> struct EventSerialization<MouseButtonPressedEvent>
+{
+    static constexpr std::string_view Name = "MouseButtonPressed";
+
+    static void Write(const MouseButtonPressedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetButton());
+    }
+
+    [[nodiscard]] static MouseButtonPressedEvent Read(EventReader &reader) noexcept
+    {
+        return MouseButtonPressedEvent(reader.Read<int32_t>());
+    }
+};
+
+template <> struct EventSerialization<MouseButtonReleasedEvent>
+{
+    static constexpr std::string_view Name = "MouseButtonReleased";
+
+    static void Write(const MouseButtonReleasedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetButton());
+    }
+
+    [[nodiscard]] static MouseButtonReleasedEvent Read(EventReader &reader) noexcept
+    {
+        return MouseButtonReleasedEvent(reader.Read<int32_t>());
+    }
+};
+
+template <> struct EventSerialization<MouseMovedEvent>
+{
+    static constexpr std::string_view Name = "MouseMoved";
+
+    static void Write(const MouseMovedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetX());
+        writer.Write(event.GetY());
+    }
+
+    [[nodiscard]] static MouseMovedEvent Read(EventReader &reader) noexcept
+    {
+        const auto x = reader.Read<float>();
+        return MouseMovedEvent(x, reader.Read<float>());
+    }
+};
+
+template <> struct EventSerialization<MouseScrolledEvent>
+{
+    static constexpr std::string_view Name = "MouseScrolled";
+
+    static void Write(const MouseScrolledEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetXOffset());
+        writer.Write(event.GetYOffset());
+    }
+
+    [[nodiscard]] static MouseScrolledEvent Read(EventReader &reader) noexcept
+    {
+        const auto xOffset = reader.Read<float>();
+        return MouseScrolledEvent(xOffset, reader.Read<float>());
+    }
+};
+
+template <> struct EventSerialization<MouseEnteredEvent> : detail::EmptyEventSerialization<MouseEnteredEvent>
+{
+    static constexpr std::string_view Name = "MouseEntered";
+};
+
+template <> struct EventSerialization<MouseExitedEvent> : detail::EmptyEventSerialization<MouseExitedEvent>
+{
+    static constexpr std::string_view Name = "MouseExited";
+};
+
+template <> struct EventSerialization<WindowResizeEvent>
+{
+    static constexpr std::string_view Name = "WindowResize";
+
+    static void Write(const WindowResizeEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetWidth());
+        writer.Write(event.GetHeight());
+    }
+
+    [[nodiscard]] static WindowResizeEvent Read(EventReader &reader) noexcept
+    {
+        const auto width = reader.Read<uint32_t>();
+        return WindowResizeEvent(width, reader.Read<uint32_t>());
+    }
+};
+
+template <> struct EventSerialization<WindowMinimizedEvent> : detail::EmptyEventSerialization<WindowMinimizedEvent>
+{
+    static constexpr std::string_view Name = "WindowMinimized";
+};
+
+template <> struct EventSerialization<WindowMaximizedEvent> : detail::EmptyEventSerialization<WindowMaximizedEvent>
+{
+    static constexpr std::string_view Name = "WindowMaximized";
+};
+
+template <> struct EventSerialization<WindowRestoredEvent> : detail::EmptyEventSerialization<WindowRestoredEvent>
+{
+    static constexpr std::string_view Name = "WindowRestored";
+};
+
+template <> struct EventSerialization<WindowMovedEvent>
+{
+    static constexpr std::string_view Name = "WindowMoved";
+
+    static void Write(const WindowMovedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetX());
+        writer.Write(event.GetY());
+    }
+
+    [[nodiscard]] static WindowMovedEvent Read(EventReader &reader) noexcept
+    {
+        const auto x = reader.Read<int32_t>();
+        return WindowMovedEvent(x, reader.Read<int32_t>());
+    }
+};
+
+template <> struct EventSerialization<WindowFocusedEvent>
+{
+    static constexpr std::string_view Name = "WindowFocused";
+
+    static void Write(const WindowFocusedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.IsFocused());
+    }
+
+    [[nodiscard]] static WindowFocusedEvent Read(EventReader &reader) noexcept
+    {
+        return WindowFocusedEvent(reader.Read<bool>());
+    }
+};
+
+template <> struct EventSerialization<WindowCloseEvent> : detail::EmptyEventSerialization<WindowCloseEvent>
+{
+    static constexpr std::string_view Name = "WindowClose";
+};
+
+template <> struct EventSerialization<FramebufferResizeEvent>
+{
+    static constexpr std::string_view Name = "FramebufferResize";
+
+    static void Write(const FramebufferResizeEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetWidth());
+        writer.Write(event.GetHeight());
+    }
+
+    [[nodiscard]] static FramebufferResizeEvent Read(EventReader &reader) noexcept
+    {
+        const auto width = reader.Read<uint32_t>();
+        return FramebufferResizeEvent(width, reader.Read<uint32_t>());
+    }
+};
+
+template <> struct EventSerialization<ContentScaleChangedEvent>
+{
+    static constexpr std::string_view Name = "ContentScaleChanged";
+
+    static void Write(const ContentScaleChangedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetXScale());
+        writer.Write(event.GetYScale());
+    }
+
+    [[nodiscard]] static ContentScaleChangedEvent Read(EventReader &reader) noexcept
+    {
+        const auto xScale = reader.Read<float>();
+        return ContentScaleChangedEvent(xScale, reader.Read<float>());
+    }
+};
+
+// NOTE: Replayed paths point into the recording instead of a FrameArena
+template <> struct EventSerialization<FileDropEvent>
+{
+    static constexpr std::string_view Name = "FileDrop";
+
+    static void Write(const FileDropEvent &event, EventWriter &writer)
+    {
+        writer.WriteStrings(event.GetPaths());
+    }
+
+    [[nodiscard]] static FileDropEvent Read(EventReader &reader)
+    {
+        return FileDropEvent(reader.ReadStrings());
+    }
+};
+
+template <> struct EventSerialization<ControllerConnectedEvent>
+{
+    static constexpr std::string_view Name = "ControllerConnected";
+
+    static void Write(const ControllerConnectedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetControllerId());
+    }
+
+    [[nodiscard]] static ControllerConnectedEvent Read(EventReader &reader) noexcept
+    {
+        return ControllerConnectedEvent(reader.Read<int32_t>());
+    }
+};
+
+template <> struct EventSerialization<ControllerDisconnectedEvent>
+{
+    static constexpr std::string_view Name = "ControllerDisconnected";
+
+    static void Write(const ControllerDisconnectedEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetControllerId());
+    }
+
+    [[nodiscard]] static ControllerDisconnectedEvent Read(EventReader &reader) noexcept
+    {
+        return ControllerDisconnectedEvent(reader.Read<int32_t>());
+    }
+};
+
+template <> struct EventSerialization<UpdateEvent>
+{
+    static constexpr std::string_view Name = "Update";
+
+    static void Write(const UpdateEvent &event, EventWriter &writer)
+    {
+        writer.Write(event.GetDeltaTime());
+    }
+
+    [[nodiscard]] static UpdateEvent Read(EventReader &reader) noexcept
+    {
+        return UpdateEvent(reader.Read<double>());
+    }
+};
+
+template <> struct EventSerialization<RenderEvent> : detail::EmptyEventSerialization<RenderEvent>
+{
+    static constexpr std::string_view Name = "Render";
+};
+
+} // namespace ae
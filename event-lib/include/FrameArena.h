@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ae
+{
+
+// NOTE: Linear bump allocator for variable-size event payloads such as FileDropEvent paths. Nothing is freed
+// individually and no destructors are run, Reset() releases everything at once. If a frame overflows the first
+// block, Reset() merges the blocks so the next frame fits in a single one
+class FrameArena
+{
+  public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+    FrameArena(FrameArena &&) = default;
+    FrameArena &operator=(FrameArena &&) = default;
+    ~FrameArena() = default;
+
+    [[nodiscard]] void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T> [[nodiscard]] std::span<T> AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+
+        auto *pData = static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            new (pData + i) T();
+        }
+
+        return std::span<T>(pData, count);
+    }
+
+    [[nodiscard]] std::span<std::byte> CopyBytes(std::span<const std::byte> bytes);
+
+    [[nodiscard]] std::string_view CopyString(std::string_view string);
+
+    // NOTE: Copies the views and the characters they point to, all in one allocation
+    [[nodiscard]] std::span<const std::string_view> CopyStrings(std::span<const std::string_view> strings);
+
+    // NOTE: Matches the GLFW drop callback signature
+    [[nodiscard]] std::span<const std::string_view> CopyStrings(const char *const *ppStrings, size_t count);
+
+    void Reset();
+
+    [[nodiscard]] size_t GetUsedBytes() const noexcept
+    {
+        return m_UsedBytes;
+    }
+
+    [[nodiscard]] size_t GetCapacity() const noexcept;
+
+  private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> pData;
+        size_t Size = 0;
+    };
+
+  private:
+    void AddBlock(size_t minimumSize);
+
+  private:
+    std::vector<Block> m_Blocks;
+    size_t m_BlockSize;
+    size_t m_Offset = 0; // NOTE: Bump offset into the last block
+    size_t m_UsedBytes = 0;
+};
+
+} // namespace ae
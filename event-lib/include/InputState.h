@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Event.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ae
+{
+
+// NOTE: Input as of the end of one frame. Key, button and controller ids index fixed-size bitsets, ids outside them
+// are never down. The pressed and released sets and the mouse delta and scroll only cover the frame they end
+struct InputSnapshot
+{
+    static constexpr int32_t MAX_KEYS = 512;
+    static constexpr int32_t MAX_MOUSE_BUTTONS = 32;
+    static constexpr int32_t MAX_CONTROLLERS = 32;
+
+    static constexpr size_t KEY_WORDS = MAX_KEYS / 64;
+
+    std::array<uint64_t, KEY_WORDS> KeysDown{};
+    std::array<uint64_t, KEY_WORDS> KeysPressed{};
+    std::array<uint64_t, KEY_WORDS> KeysReleased{};
+    uint32_t ButtonsDown = 0;
+    uint32_t ButtonsPressed = 0;
+    uint32_t ButtonsReleased = 0;
+    uint32_t ControllersConnected = 0;
+
+    float MouseX = 0.0f;
+    float MouseY = 0.0f;
+    float MouseDeltaX = 0.0f;
+    float MouseDeltaY = 0.0f;
+    float ScrollX = 0.0f;
+    float ScrollY = 0.0f;
+
+    uint64_t Frame = 0; // NOTE: Number of frames published before this one
+    bool MouseInWindow = false;
+    bool WindowFocused = true;
+
+    [[nodiscard]] bool IsKeyDown(int32_t keyCode) const noexcept
+    {
+        return TestKey(KeysDown, keyCode);
+    }
+
+    // NOTE: True for the frame the key went down, key repeats do not count
+    [[nodiscard]] bool WasKeyPressed(int32_t keyCode) const noexcept
+    {
+        return TestKey(KeysPressed, keyCode);
+    }
+
+    [[nodiscard]] bool WasKeyReleased(int32_t keyCode) const noexcept
+    {
+        return TestKey(KeysReleased, keyCode);
+    }
+
+    [[nodiscard]] bool IsMouseButtonDown(int32_t button) const noexcept
+    {
+        return TestBit(ButtonsDown, button, MAX_MOUSE_BUTTONS);
+    }
+
+    [[nodiscard]] bool WasMouseButtonPressed(int32_t button) const noexcept
+    {
+        return TestBit(ButtonsPressed, button, MAX_MOUSE_BUTTONS);
+    }
+
+    [[nodiscard]] bool WasMouseButtonReleased(int32_t button) const noexcept
+    {
+        return TestBit(ButtonsReleased, button, MAX_MOUSE_BUTTONS);
+    }
+
+    [[nodiscard]] bool IsControllerConnected(int32_t controllerId) const noexcept
+    {
+        return TestBit(ControllersConnected, controllerId, MAX_CONTROLLERS);
+    }
+
+  private:
+    [[nodiscard]] static bool TestKey(const std::array<uint64_t, KEY_WORDS> &keys, int32_t keyCode) noexcept
+    {
+        return keyCode >= 0 && keyCode < MAX_KEYS && (keys[keyCode / 64] >> (keyCode % 64) & 1) != 0;
+    }
+
+    [[nodiscard]] static bool TestBit(uint32_t bits, int32_t index, int32_t count) noexcept
+    {
+        return index >= 0 && index < count && (bits >> index & 1) != 0;
+    }
+};
+
+// NOTE: Keeps one mirror of keyboard, mouse and controller state for every layer, fed by a single listener on the
+// bus. The dispatching thread reads the live state, Publish() ends the frame and makes it the snapshot that any
+// thread can read without locks. Controllers are only tracked as connected until controller input events exist
+class InputState
+{
+  public:
+    InputState();
+    explicit InputState(EventBus &bus);
+    InputState(const InputState &) = delete;
+    InputState &operator=(const InputState &) = delete;
+    InputState(InputState &&) = delete;
+    InputState &operator=(InputState &&) = delete;
+    ~InputState() = default;
+
+    // NOTE: Call once per frame on the dispatching thread, after the frame's events were flushed
+    void Publish() noexcept;
+
+    // NOTE: Any thread, never blocks. Retries while Publish() is overwriting the buffer being read, which only
+    // happens to a reader that is a whole frame behind
+    [[nodiscard]] InputSnapshot GetSnapshot() const noexcept;
+
+    // NOTE: The state of the frame in progress, only valid on the dispatching thread
+    [[nodiscard]] const InputSnapshot &GetCurrent() const noexcept
+    {
+        return m_Current;
+    }
+
+  private:
+    static constexpr size_t SNAPSHOT_WORDS = sizeof(InputSnapshot) / sizeof(uint64_t);
+
+    static_assert(std::is_trivially_copyable_v<InputSnapshot>, "InputSnapshot is copied word by word");
+    static_assert(sizeof(InputSnapshot) % sizeof(uint64_t) == 0, "InputSnapshot must be a whole number of words");
+
+    // NOTE: Seqlock slot. The sequence is odd while the words are written, and the words are relaxed atomics so a
+    // torn read is detected rather than undefined
+    struct alignas(64) SnapshotSlot
+    {
+        std::atomic<uint32_t> Sequence = 0;
+        std::array<std::atomic<uint64_t>, SNAPSHOT_WORDS> Words{};
+    };
+
+  private:
+    void OnEvent(Event &event) noexcept;
+
+    void ReleaseAll() noexcept;
+
+    static void SetBit(std::array<uint64_t, InputSnapshot::KEY_WORDS> &keys, int32_t keyCode, bool value) noexcept;
+
+  private:
+    InputSnapshot m_Current;
+    std::array<SnapshotSlot, 2> m_Slots;
+    std::atomic<uint32_t> m_PublishedSlot = 0;
+    bool m_HasMousePosition = false;
+    EventListener m_Listener;
+};
+
+} // namespace ae
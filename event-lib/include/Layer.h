@@ -1,24 +1,64 @@
 #pragma once
 
 #include "Event.h"
+#include "ThreadPool.h"
 
 #include <cstdint>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <vector>
 
 namespace ae
 {
 
+class LayerStack;
+
+// NOTE: The per-frame hooks of a layer. A LayerStack only calls the hooks a layer implements
+enum class LayerHook : uint8_t
+{
+    NONE = 0,
+    UPDATE = 1 << 0,
+    RENDER = 1 << 1,
+    IMGUI_RENDER = 1 << 2,
+    ALL = UPDATE | RENDER | IMGUI_RENDER,
+};
+
+[[nodiscard]] constexpr LayerHook operator|(LayerHook lhs, LayerHook rhs) noexcept
+{
+    return static_cast<LayerHook>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+}
+
+[[nodiscard]] constexpr LayerHook operator&(LayerHook lhs, LayerHook rhs) noexcept
+{
+    return static_cast<LayerHook>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs));
+}
+
+// NOTE: Generation-checked reference to a layer in a LayerStack, stale once the layer was removed
+struct LayerHandle
+{
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    uint32_t Index = INVALID_INDEX;
+    uint32_t Generation = 0;
+
+    [[nodiscard]] constexpr bool IsValid() const noexcept
+    {
+        return Index != INVALID_INDEX;
+    }
+};
+
 class Layer
 {
     friend class LayerStack;
 
   public:
     explicit Layer(const std::string &name = "Layer");
+    // NOTE: Not movable, the stack it is pushed to keeps pointers to it and it points back at that stack
     Layer(const Layer &) = delete;
     Layer &operator=(const Layer &) = delete;
-    Layer(Layer &&) = default;
-    Layer &operator=(Layer &&) = default;
+    Layer(Layer &&) = delete;
+    Layer &operator=(Layer &&) = delete;
     virtual ~Layer() = default;
 
     [[nodiscard]] const std::string &GetName() const noexcept
@@ -31,14 +71,77 @@ class Layer
         return m_Enabled;
     }
 
-    void SetEnabled(bool enabled) noexcept
+    // NOTE: Toggling a layer that is in a LayerStack makes the stack rebuild its event routes and phase lists
+    void SetEnabled(bool enabled) noexcept;
+
+    // NOTE: The hooks the layer both declares and, when pushed with its own type, was detected to override
+    [[nodiscard]] LayerHook GetHooks() const noexcept
     {
-        m_Enabled = enabled;
+        return m_DeclaredHooks & m_DetectedHooks;
+    }
+
+    [[nodiscard]] bool ImplementsHook(LayerHook hook) const noexcept
+    {
+        return (GetHooks() & hook) != LayerHook::NONE;
+    }
+
+    // NOTE: A layer that declares no event types and no categories receives every event
+    [[nodiscard]] bool HandlesAllEvents() const noexcept
+    {
+        return m_EventTypeIds.empty() && m_EventCategories == EventCategory::NONE;
+    }
+
+    [[nodiscard]] bool HandlesEvent(uint32_t typeId, EventCategoryWrapper categories) const noexcept;
+
+    [[nodiscard]] uint32_t GetUpdateGroup() const noexcept
+    {
+        return m_UpdateGroup;
+    }
+
+    // NOTE: Layers in a non-zero group may update concurrently with layers in other groups under
+    // LayerStack::OnUpdateParallel(). Layers sharing a group still update in stack order on the same thread. Group 0,
+    // the default, keeps the layer strictly ordered against everything around it
+    void SetUpdateGroup(uint32_t group) noexcept
+    {
+        m_UpdateGroup = group;
     }
 
+  protected:
+    // NOTE: Restricts OnEvent to the given event types, in addition to any declared categories
+    template <typename... Ts> void SubscribeToEvents()
+    {
+        (m_EventTypeIds.push_back(EventTypeId<Ts>::Get()), ...);
+        OnEventInterestChanged();
+    }
+
+    // NOTE: Restricts OnEvent to events in at least one of the given categories, in addition to any declared types
+    void SubscribeToCategories(EventCategoryWrapper categories);
+
+    // NOTE: Declares which of OnUpdate, OnRender and OnImGuiRender the layer implements, for layers pushed through a
+    // base pointer where the LayerStack cannot detect it. Every hook is declared by default
+    void DeclareHooks(LayerHook hooks) noexcept;
+
   protected:
     std::string m_Name;
-    bool m_Enabled = true;
+    bool m_Enabled = true; // NOTE: Change through SetEnabled(), a LayerStack only sees the change then
+
+  private:
+    void OnEventInterestChanged() noexcept;
+
+    void OnHooksChanged() noexcept;
+
+  private:
+    std::vector<uint32_t> m_EventTypeIds;
+    EventCategoryWrapper m_EventCategories;
+    uint32_t m_UpdateGroup = 0;
+    LayerHook m_DeclaredHooks = LayerHook::ALL;
+    LayerHook m_DetectedHooks = LayerHook::ALL; // NOTE: Set by LayerStack::PushLayer<T>() and PushOverlay<T>()
+    LayerStack *m_pLayerStack = nullptr; // NOTE: Set while the layer is pushed to a stack, including while queued
+    LayerHandle m_Handle;
+    uint32_t m_StackIndex = INVALID_STACK_INDEX; // NOTE: Position in the stack, invalid while queued
+
+  private:
+    static constexpr uint32_t INVALID_STACK_INDEX = UINT32_MAX;
 
   private:
     virtual void OnAttach() {}
@@ -56,30 +159,71 @@ class Layer
 
 class LayerStack
 {
+    friend class Layer;
+
   public:
     LayerStack();
+    // NOTE: Not movable, its layers point back at it and its listener is bound to this address
     LayerStack(const LayerStack &) = delete;
     LayerStack &operator=(const LayerStack &) = delete;
-    LayerStack(LayerStack &&) = default;
-    LayerStack &operator=(LayerStack &&) = default;
+    LayerStack(LayerStack &&) = delete;
+    LayerStack &operator=(LayerStack &&) = delete;
     ~LayerStack();
 
-    void PushLayer(Layer *pLayer);
+    // NOTE: Layers pushed while the stack is dispatching an event or running a phase are queued and attached at the
+    // next safe point, right after the outermost dispatch or phase returns. The handle is valid immediately
+    LayerHandle PushLayer(Layer *pLayer);
 
+    // NOTE: Also detects at compile time which per-frame hooks T overrides, so the stack skips the empty defaults
+    template <typename T>
+        requires std::is_base_of_v<Layer, T>
+    LayerHandle PushLayer(T *pLayer)
+    {
+        DetectHooks(pLayer);
+        return PushLayer(static_cast<Layer *>(pLayer));
+    }
+
+    // NOTE: Removal is safe at any time and the layer is detached at once, so it may be deleted right after. During a
+    // dispatch or phase removal is O(1) and the slot it leaves is compacted at the next safe point. Otherwise the
+    // layers above it move down at once, so it is O(n) in the number of layers and overlays above
     void PopLayer(Layer *pLayer);
 
-    void PushOverlay(Layer *pOverlay);
+    LayerHandle PushOverlay(Layer *pOverlay);
+
+    template <typename T>
+        requires std::is_base_of_v<Layer, T>
+    LayerHandle PushOverlay(T *pOverlay)
+    {
+        DetectHooks(pOverlay);
+        return PushOverlay(static_cast<Layer *>(pOverlay));
+    }
 
     void PopOverlay(Layer *pOverlay);
 
+    // NOTE: Removes a layer or overlay, returns false if the handle is stale
+    bool Remove(LayerHandle handle);
+
+    // NOTE: nullptr if the handle is stale
+    [[nodiscard]] Layer *Get(LayerHandle handle) const noexcept;
+
+    // NOTE: Attaches queued layers and compacts removed ones. Runs on its own after every outermost dispatch and phase,
+    // and does nothing while one is in progress
+    void ApplyPendingChanges();
+
     void OnEvent(Event &event);
 
     void OnUpdate(double deltaTime);
 
+    // NOTE: Like OnUpdate(), but runs layers of different update groups concurrently on the pool. Ungrouped layers
+    // act as barriers, and the call returns once every layer has updated so OnRender() sees a finished frame. Layers
+    // must not push, pop or toggle layers from OnUpdate() while this runs
+    void OnUpdateParallel(double deltaTime, ThreadPool &threadPool);
+
     void OnRender();
 
     void OnImGuiRender();
 
+    // NOTE: Iteration is bottom to top. Only yields nullptr for layers removed by a dispatch or phase still in progress
     [[nodiscard]] auto begin() noexcept
     {
         return m_Layers.begin();
@@ -120,20 +264,212 @@ class LayerStack
         return m_Layers.rend();
     }
 
+    // NOTE: Attached layers and overlays, queued ones are not counted until they are attached
     [[nodiscard]] size_t Size() const noexcept
     {
-        return m_Layers.size();
+        return m_Layers.size() - m_RemovedCount;
     }
 
     [[nodiscard]] bool Empty() const noexcept
     {
-        return m_Layers.empty();
+        return Size() == 0;
     }
 
   private:
-    std::vector<Layer *> m_Layers;
+    [[nodiscard]] bool IsIterating() const noexcept
+    {
+        return m_DispatchDepth > 0 || m_PhaseDepth > 0;
+    }
+
+    // NOTE: Resolves an entry of an event route or phase list. The handle is checked without touching the layer, since
+    // a layer removed during a dispatch or phase may already be deleted. nullptr once the layer was removed
+    [[nodiscard]] Layer *GetListedLayer(LayerHandle handle) const noexcept
+    {
+        const LayerSlot &slot = m_Slots[handle.Index];
+        return slot.Generation == handle.Generation ? slot.pLayer : nullptr;
+    }
+
+    [[nodiscard]] bool HasPendingChanges() const noexcept
+    {
+        return m_RemovedCount > 0 || !m_PendingLayers.empty();
+    }
+
+    [[nodiscard]] LayerHandle Register(Layer *pLayer, bool overlay);
+
+    void Insert(Layer *pLayer, bool overlay);
+
+    void Unregister(Layer *pLayer);
+
+    void CompactLayers() noexcept;
+
+    void Attach(Layer *pLayer);
+
+    void Detach(Layer *pLayer);
+
+    void InvalidateEventRoutes() noexcept
+    {
+        m_EventRoutesDirty = true;
+    }
+
+    void InvalidatePhases() noexcept
+    {
+        m_PhasesDirty = true;
+    }
+
+    // NOTE: Phase lists can only be rebuilt when no phase is iterating them
+    void BeginPhase()
+    {
+        if (m_PhaseDepth == 0 && m_DispatchDepth == 0)
+        {
+            if (HasPendingChanges())
+            {
+                ApplyPendingChanges();
+            }
+
+            if (m_PhasesDirty)
+            {
+                RebuildPhases();
+            }
+        }
+
+        m_PhaseDepth++;
+    }
+
+    void EndPhase()
+    {
+        m_PhaseDepth--;
+
+        if (HasPendingChanges() && !IsIterating())
+        {
+            ApplyPendingChanges();
+        }
+    }
+
+    void RebuildPhases();
+
+    // NOTE: A phase that saw a structural change skips the layers popped or disabled since its list was built
+    [[nodiscard]] Layer *GetPhaseLayer(LayerHandle handle) const noexcept
+    {
+        Layer *pLayer = GetListedLayer(handle);
+        return pLayer != nullptr && (!m_PhasesDirty || pLayer->IsEnabled()) ? pLayer : nullptr;
+    }
+
+    // NOTE: A hook T cannot name was overridden privately or protected, one that still has the type of the Layer
+    // default was not overridden
+    template <typename T> [[nodiscard]] static consteval LayerHook GetOverriddenHooks() noexcept
+    {
+        LayerHook hooks = LayerHook::NONE;
+
+        if constexpr (requires { &T::OnUpdate; })
+        {
+            if constexpr (!std::is_same_v<decltype(&T::OnUpdate), void (Layer::*)(double)>)
+            {
+                hooks = hooks | LayerHook::UPDATE;
+            }
+        }
+        else
+        {
+            hooks = hooks | LayerHook::UPDATE;
+        }
+
+        if constexpr (requires { &T::OnRender; })
+        {
+            if constexpr (!std::is_same_v<decltype(&T::OnRender), void (Layer::*)()>)
+            {
+                hooks = hooks | LayerHook::RENDER;
+            }
+        }
+        else
+        {
+            hooks = hooks | LayerHook::RENDER;
+        }
+
+        if constexpr (requires { &T::OnImGuiRender; })
+        {
+            if constexpr (!std::is_same_v<decltype(&T::OnImGuiRender), void (Layer::*)()>)
+            {
+                hooks = hooks | LayerHook::IMGUI_RENDER;
+            }
+        }
+        else
+        {
+            hooks = hooks | LayerHook::IMGUI_RENDER;
+        }
+
+        return hooks;
+    }
+
+    // NOTE: Detection is only exact for the dynamic type. A layer pushed through a pointer to one of its bases keeps
+    // every hook it declares
+    template <typename T> static void DetectHooks(T *pLayer) noexcept
+    {
+        if (pLayer != nullptr)
+        {
+            pLayer->m_DetectedHooks = typeid(*pLayer) == typeid(T) ? GetOverriddenHooks<T>() : LayerHook::ALL;
+        }
+    }
+
+    [[nodiscard]] const std::vector<LayerHandle> &GetEventRoute(uint32_t typeIndex, const Event &event);
+
+    void UpdateGroupsParallel(size_t begin, size_t end, double deltaTime, ThreadPool &threadPool);
+
+    static void DispatchToLayer(Layer *pLayer, Event &event);
+
+  private:
+    struct EventRoute
+    {
+        std::vector<LayerHandle> Layers;
+        bool Built = false;
+    };
+
+    struct LayerSlot
+    {
+        Layer *pLayer = nullptr; // NOTE: nullptr while the slot is free
+        uint32_t Generation = 0;
+        uint32_t NextFree = LayerHandle::INVALID_INDEX;
+        bool Overlay = false;
+    };
+
+    struct PendingLayer
+    {
+        Layer *pLayer; // NOTE: nullptr once removed again before it was attached
+        bool Overlay;
+    };
+
+    struct UpdateGroupTask
+    {
+        const LayerStack *pLayerStack;
+        const LayerHandle *pBegin;
+        const LayerHandle *pEnd;
+        uint32_t Group;
+        double DeltaTime;
+    };
+
+  private:
+    std::vector<Layer *> m_Layers; // NOTE: nullptr marks a layer removed during a dispatch or phase
     uint32_t m_LayerInsertIndex = 0; // NOTE: Boundary between layers and overlays
+    uint32_t m_RemovedCount = 0;
+
+    std::vector<LayerSlot> m_Slots;
+    uint32_t m_FreeSlots = LayerHandle::INVALID_INDEX;
+    std::vector<PendingLayer> m_PendingLayers; // NOTE: Pushed during a dispatch or phase, in push order
     EventListener m_Listener;
+
+    // NOTE: Indexed by detail::GetEventTypeIndex(), the enabled layers interested in each type from top to bottom.
+    // Built lazily on first dispatch
+    std::vector<EventRoute> m_EventRoutes;
+    uint32_t m_DispatchDepth = 0;
+    bool m_EventRoutesDirty = false;
+
+    // NOTE: The enabled layers implementing each per-frame hook, from bottom to top. Rebuilt lazily after a push, a
+    // pop or a toggle, so each phase only touches the layers it calls
+    std::vector<LayerHandle> m_UpdateLayers;
+    std::vector<LayerHandle> m_RenderLayers;
+    std::vector<LayerHandle> m_ImGuiRenderLayers;
+    uint32_t m_PhaseDepth = 0;
+    bool m_PhasesDirty = false;
+
+    std::vector<UpdateGroupTask> m_UpdateGroupTasks; // NOTE: Reused every frame by OnUpdateParallel()
 };
 
 } // namespace ae
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace ae
+{
+
+// NOTE: Read-only memory mapping of a whole file. Pages are loaded on first access, so large files stream from disk
+// instead of being read up front
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    bool Open(const std::string &path);
+
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept
+    {
+        return m_IsOpen;
+    }
+
+    [[nodiscard]] std::span<const std::byte> GetData() const noexcept
+    {
+        return { m_pData, m_Size };
+    }
+
+  private:
+    const std::byte *m_pData = nullptr;
+    size_t m_Size = 0;
+    bool m_IsOpen = false;
+
+#ifdef AE_WINDOWS
+    void *m_pFileHandle = nullptr;
+    void *m_pMappingHandle = nullptr;
+#endif
+};
+
+} // namespace ae
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Event.h"
+#include "EventRecording.h"
+#include "SharedMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ae
+{
+
+namespace detail
+{
+
+// NOTE: Start of the shared memory, defined in SharedEventBridge.cpp together with the record layout
+struct SharedEventRingHeader;
+
+} // namespace detail
+
+// NOTE: Publishes every event dispatched on a bus into a lock-free single-producer ring in shared memory, for tools
+// in other processes. Payloads use the EventSerialization layout of recordings and types are identified by name, so
+// custom types need RegisterRecordableEvents() on both sides. Never blocks: when the reader falls a whole ring behind,
+// events are dropped and counted. Nothing is published while no subscriber is attached. Events a
+// SharedEventSubscriber ingests, and events dispatched while handling them, are not published again, so two processes
+// can bridge in both directions without echoing each other's events
+class SharedEventPublisher
+{
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024 * 1024;
+
+    SharedEventPublisher();
+    explicit SharedEventPublisher(EventBus &bus) noexcept;
+    SharedEventPublisher(const SharedEventPublisher &) = delete;
+    SharedEventPublisher &operator=(const SharedEventPublisher &) = delete;
+    ~SharedEventPublisher();
+
+    // NOTE: Creates the shared memory under the given name. The capacity is in bytes, rounded up to a power of two
+    bool Start(const std::string &name, size_t capacity = DEFAULT_CAPACITY);
+
+    // NOTE: Removes the name, readers that have it open can still drain what was published
+    void Stop();
+
+    [[nodiscard]] bool IsPublishing() const noexcept
+    {
+        return m_pHeader != nullptr;
+    }
+
+    [[nodiscard]] uint64_t GetPublishedEventCount() const noexcept
+    {
+        return m_PublishedEventCount;
+    }
+
+    [[nodiscard]] uint64_t GetDroppedEventCount() const noexcept;
+
+    // NOTE: Whether a SharedEventSubscriber has the ring open. Events dispatched without one are skipped, they are
+    // neither published nor counted as dropped
+    [[nodiscard]] bool HasSubscriber() const noexcept;
+
+  private:
+    static constexpr uint16_t UNASSIGNED_SLOT = UINT16_MAX;
+    static constexpr uint16_t SKIPPED_SLOT = UINT16_MAX - 1; // NOTE: Not publishable, warned about once
+
+  private:
+    void OnEvent(Event &event);
+
+    // NOTE: Adds the type's name to the shared type table on its first event
+    [[nodiscard]] uint16_t GetTypeSlot(uint32_t typeIndex, const detail::RecordableEventType &type);
+
+    bool WriteRecord(uint16_t typeSlot, uint64_t timestampNs);
+
+  private:
+    EventBus &m_Bus;
+    SharedMemory m_Memory;
+    detail::SharedEventRingHeader *m_pHeader = nullptr;
+    std::byte *m_pRing = nullptr;
+    uint64_t m_Capacity = 0;
+    std::vector<std::byte> m_Payload;  // NOTE: Reused, so the steady state does not allocate
+    std::vector<uint16_t> m_TypeSlots; // NOTE: Indexed by detail::GetEventTypeIndex()
+    uint64_t m_PublishedEventCount = 0;
+    std::optional<EventListener> m_Listener; // NOTE: Only registered while publishing
+};
+
+// NOTE: Reads the ring of a SharedEventPublisher in another process and dispatches its events. Like EventReplay,
+// events go through Event::Dispatch() unless a target is given. Only one subscriber may read a ring at a time
+class SharedEventSubscriber
+{
+  public:
+    SharedEventSubscriber() = default;
+    SharedEventSubscriber(const SharedEventSubscriber &) = delete;
+    SharedEventSubscriber &operator=(const SharedEventSubscriber &) = delete;
+    ~SharedEventSubscriber() = default;
+
+    // NOTE: Fails until the publisher has started, callers retry to attach to a process that starts later. Only events
+    // published after Open() are dispatched, whatever the ring held before is skipped
+    bool Open(const std::string &name);
+
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept
+    {
+        return m_pHeader != nullptr;
+    }
+
+    // NOTE: Dispatches every event published since the last call. Returns the number of events dispatched. Strings
+    // such as FileDropEvent paths point into the ring and are only valid while the event is dispatched
+    size_t Poll(EventDelegate target = EventDelegate());
+
+    // NOTE: Events the publisher dropped because this subscriber fell behind
+    [[nodiscard]] uint64_t GetDroppedEventCount() const noexcept;
+
+  private:
+    struct SharedType
+    {
+        uint32_t TypeIndex = detail::INVALID_EVENT_TYPE_INDEX; // NOTE: Dense index of the matching registered type
+        bool Resolved = false;
+        bool Warned = false;
+    };
+
+  private:
+    [[nodiscard]] SharedType &ResolveType(uint16_t typeSlot);
+
+  private:
+    SharedMemory m_Memory;
+    detail::SharedEventRingHeader *m_pHeader = nullptr;
+    const std::byte *m_pRing = nullptr;
+    uint64_t m_Capacity = 0;
+    std::vector<SharedType> m_Types; // NOTE: Indexed by the publisher's type slot
+    std::vector<std::string_view> m_Strings;
+};
+
+} // namespace ae
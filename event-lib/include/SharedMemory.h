@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace ae
+{
+
+// NOTE: Named read-write memory shared between processes, zero-filled when created. The process that created it owns
+// the name and removes it on Close(), processes that opened it only unmap it. On POSIX systems names are shm_open()
+// names and get a leading slash if they lack one
+class SharedMemory
+{
+  public:
+    SharedMemory() = default;
+    SharedMemory(const SharedMemory &) = delete;
+    SharedMemory &operator=(const SharedMemory &) = delete;
+    ~SharedMemory();
+
+    bool Create(const std::string &name, size_t size);
+
+    bool Open(const std::string &name);
+
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept
+    {
+        return m_IsOpen;
+    }
+
+    [[nodiscard]] bool IsOwner() const noexcept
+    {
+        return m_IsOwner;
+    }
+
+    [[nodiscard]] std::span<std::byte> GetData() const noexcept
+    {
+        return { m_pData, m_Size };
+    }
+
+  private:
+    std::byte *m_pData = nullptr;
+    size_t m_Size = 0;
+    bool m_IsOpen = false;
+    bool m_IsOwner = false;
+
+#ifdef AE_WINDOWS
+    void *m_pMappingHandle = nullptr; // NOTE: The mapping is removed once the last process closes its handle
+#else
+    std::string m_Name; // NOTE: Unlinked on Close() by the owner
+#endif
+};
+
+} // namespace ae
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "Event.h"
+#include "EventDispatcher.h"
+#include "EventInstrumentation.h"
+#include "EventManager.h"
+#include "TraceRecorder.h"
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ae
+{
+
+namespace detail
+{
+
+// NOTE: The event type a static layer's OnEvent takes, Event for layers that handle every event
+template <typename T> struct StaticLayerEventType
+{
+    using Type = Event;
+};
+
+template <typename T>
+    requires requires { &T::OnEvent; }
+struct StaticLayerEventType<T>
+{
+    using Type = HandlerEventType<decltype(&T::OnEvent)>;
+};
+
+// NOTE: Runs a layer hook, recording it as a span while a trace is being recorded if the layer has a GetName()
+template <typename T, typename Callback>
+void InvokeStaticLayer([[maybe_unused]] const T &layer, [[maybe_unused]] const char *pCategory, Callback &&callback)
+{
+#ifdef AE_EVENT_INSTRUMENTATION
+    if constexpr (requires { layer.GetName(); })
+    {
+        TraceRecorder &traceRecorder = TraceRecorder::Get();
+
+        if (traceRecorder.IsRecording())
+        {
+            const uint64_t start = EventInstrumentation::ReadTimestamp();
+            callback();
+            traceRecorder.RecordSpan(layer.GetName(), pCategory, start, EventInstrumentation::ReadTimestamp());
+            return;
+        }
+    }
+#endif
+
+    callback();
+}
+
+} // namespace detail
+
+// NOTE: A LayerStack fixed at compile time. Layers are held by value from bottom to top, the last ones act as
+// overlays. They are plain types rather than ae::Layer subclasses: OnAttach, OnDetach, OnEvent, OnUpdate(double),
+// OnRender and OnImGuiRender are all optional public members, called directly so they can be inlined, and a hook a
+// layer does not declare costs nothing. OnEvent may take a concrete event type to only receive that type, and may
+// return bool to consume the event by returning true. An overloaded OnEvent is called with Event &. Events propagate
+// top-to-bottom, update and render bottom-to-top, as with LayerStack
+template <typename... Layers> class StaticLayerStack
+{
+    static_assert(sizeof...(Layers) > 0, "StaticLayerStack needs at least one layer");
+    static_assert(detail::AllUnique<Layers...>::value, "Each layer type may only appear once");
+    static_assert((std::is_base_of_v<Event, typename detail::StaticLayerEventType<Layers>::Type> && ...),
+                  "OnEvent must take a reference to an event type");
+
+  public:
+    static constexpr size_t LAYER_COUNT = sizeof...(Layers);
+
+  public:
+    StaticLayerStack() : StaticLayerStack(EventManager::Get())
+    {
+    }
+
+    // NOTE: Receives the events dispatched on the given bus instead of the global one
+    explicit StaticLayerStack(EventBus &bus) : m_Listener(bus, EventDelegate::Bind<&StaticLayerStack::OnEvent>(this))
+    {
+        m_Enabled.fill(true);
+
+        // NOTE: Attach bottom-to-top, in the order the layers would have been pushed
+        ForEachLayer(
+            [](auto &layer)
+            {
+                if constexpr (requires { layer.OnAttach(); })
+                {
+                    layer.OnAttach();
+                }
+            });
+    }
+
+    StaticLayerStack(const StaticLayerStack &) = delete;
+    StaticLayerStack &operator=(const StaticLayerStack &) = delete;
+    StaticLayerStack(StaticLayerStack &&) = delete;
+    StaticLayerStack &operator=(StaticLayerStack &&) = delete;
+
+    ~StaticLayerStack()
+    {
+        ForEachLayer(
+            [](auto &layer)
+            {
+                if constexpr (requires { layer.OnDetach(); })
+                {
+                    layer.OnDetach();
+                }
+            });
+    }
+
+    void OnEvent(Event &event)
+    {
+        // NOTE: Events propagate top-to-bottom, the fold stops at the first layer that consumes
+        [this, &event]<size_t... I>(std::index_sequence<I...>)
+        { static_cast<void>((DispatchToLayer<LAYER_COUNT - 1 - I>(event) && ...)); }(
+            std::index_sequence_for<Layers...>{});
+    }
+
+    void OnUpdate(double deltaTime)
+    {
+        // NOTE: Update propagates bottom-to-top
+        ForEachEnabledLayer(
+            [deltaTime](auto &layer)
+            {
+                if constexpr (requires { layer.OnUpdate(deltaTime); })
+                {
+                    detail::InvokeStaticLayer(layer, "update", [&layer, deltaTime] { layer.OnUpdate(deltaTime); });
+                }
+            });
+    }
+
+    void OnRender()
+    {
+        // NOTE: Render propagates bottom-to-top
+        ForEachEnabledLayer(
+            [](auto &layer)
+            {
+                if constexpr (requires { layer.OnRender(); })
+                {
+                    detail::InvokeStaticLayer(layer, "render", [&layer] { layer.OnRender(); });
+                }
+            });
+    }
+
+    void OnImGuiRender()
+    {
+        // NOTE: ImGui render propagates bottom-to-top
+        ForEachEnabledLayer(
+            [](auto &layer)
+            {
+                if constexpr (requires { layer.OnImGuiRender(); })
+                {
+                    detail::InvokeStaticLayer(layer, "imgui", [&layer] { layer.OnImGuiRender(); });
+                }
+            });
+    }
+
+    template <typename T> [[nodiscard]] T &Get() noexcept
+    {
+        return std::get<T>(m_Layers);
+    }
+
+    template <typename T> [[nodiscard]] const T &Get() const noexcept
+    {
+        return std::get<T>(m_Layers);
+    }
+
+    template <typename T> [[nodiscard]] bool IsEnabled() const noexcept
+    {
+        static_assert(IndexOf<T>() < LAYER_COUNT, "Layer type is not in the StaticLayerStack");
+        return m_Enabled[IndexOf<T>()];
+    }
+
+    // NOTE: A disabled layer receives no events and is skipped by update and render
+    template <typename T> void SetEnabled(bool enabled) noexcept
+    {
+        static_assert(IndexOf<T>() < LAYER_COUNT, "Layer type is not in the StaticLayerStack");
+        m_Enabled[IndexOf<T>()] = enabled;
+    }
+
+    [[nodiscard]] EventListener &GetListener() noexcept
+    {
+        return m_Listener;
+    }
+
+    [[nodiscard]] static constexpr size_t Size() noexcept
+    {
+        return LAYER_COUNT;
+    }
+
+  private:
+    template <typename T> [[nodiscard]] static consteval size_t IndexOf() noexcept
+    {
+        constexpr std::array<bool, LAYER_COUNT> matches = { std::is_same_v<T, Layers>... };
+
+        for (size_t i = 0; i < LAYER_COUNT; i++)
+        {
+            if (matches[i])
+            {
+                return i;
+            }
+        }
+
+        return LAYER_COUNT;
+    }
+
+    // NOTE: Returns false once the event is consumed, which ends propagation
+    template <size_t I> bool DispatchToLayer(Event &event)
+    {
+        using LayerType = std::tuple_element_t<I, std::tuple<Layers...>>;
+        using EventType = typename detail::StaticLayerEventType<LayerType>::Type;
+
+        if constexpr (requires(LayerType &layer, EventType &typedEvent) { layer.OnEvent(typedEvent); })
+        {
+            if (!m_Enabled[I])
+            {
+                return true;
+            }
+
+            if constexpr (!std::is_same_v<EventType, Event>)
+            {
+                if (event.GetTypeId() != EventTypeId<EventType>::Get())
+                {
+                    return true;
+                }
+            }
+
+            LayerType &layer = std::get<I>(m_Layers);
+            auto &typedEvent = static_cast<EventType &>(event);
+
+            if constexpr (std::is_same_v<decltype(layer.OnEvent(typedEvent)), bool>)
+            {
+                if (layer.OnEvent(typedEvent))
+                {
+                    event.Consume();
+                }
+            }
+            else
+            {
+                layer.OnEvent(typedEvent);
+            }
+        }
+
+        return !event.IsConsumed();
+    }
+
+    template <typename F> void ForEachLayer(F &&function)
+    {
+        std::apply([&function](auto &...layers) { (function(layers), ...); }, m_Layers);
+    }
+
+    template <typename F> void ForEachEnabledLayer(F &&function)
+    {
+        [this, &function]<size_t... I>(std::index_sequence<I...>)
+        {
+            static_cast<void>(((m_Enabled[I] ? function(std::get<I>(m_Layers)) : void()), ...));
+        }(std::index_sequence_for<Layers...>{});
+    }
+
+  private:
+    std::tuple<Layers...> m_Layers;
+    std::array<bool, LAYER_COUNT> m_Enabled;
+    EventListener m_Listener;
+};
+
+} // namespace ae
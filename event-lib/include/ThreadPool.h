@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ae
+{
+
+// NOTE: A task is a plain function pointer and context pointer, so submitting one never allocates. The context must
+// stay alive until the task has run
+struct Task
+{
+    void (*pFunction)(void *pContext) = nullptr;
+    void *pContext = nullptr;
+};
+
+// NOTE: Counts outstanding tasks. Wait on it through ThreadPool::Wait() so the waiting thread helps with the work
+class TaskLatch
+{
+  public:
+    TaskLatch() = default;
+    TaskLatch(const TaskLatch &) = delete;
+    TaskLatch &operator=(const TaskLatch &) = delete;
+    TaskLatch(TaskLatch &&) = delete;
+    TaskLatch &operator=(TaskLatch &&) = delete;
+    ~TaskLatch() = default;
+
+    void Add(uint32_t count = 1) noexcept
+    {
+        m_Pending.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void CountDown() noexcept
+    {
+        if (m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_Pending.notify_all();
+        }
+    }
+
+    [[nodiscard]] bool IsDone() const noexcept
+    {
+        return m_Pending.load(std::memory_order_acquire) == 0;
+    }
+
+  private:
+    friend class ThreadPool;
+
+    std::atomic<uint32_t> m_Pending = 0;
+};
+
+// NOTE: Fixed set of worker threads with one task deque each. Workers pop their own deque from the back and steal
+// from the front of the others when they run dry. Tasks must not throw
+class ThreadPool
+{
+  public:
+    static constexpr size_t MAX_QUEUED_TASKS_PER_WORKER = 256;
+
+    // NOTE: Defaults to one worker per hardware thread, minus the thread that submits and waits
+    explicit ThreadPool(uint32_t workerCount = GetDefaultWorkerCount());
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+    ~ThreadPool();
+
+    // NOTE: Counts the task on the latch and queues it. If every deque is full the task runs on the calling thread
+    void Submit(Task task, TaskLatch &latch);
+
+    // NOTE: Runs queued tasks on the calling thread until the latch reaches zero
+    void Wait(TaskLatch &latch);
+
+    [[nodiscard]] uint32_t GetWorkerCount() const noexcept
+    {
+        return static_cast<uint32_t>(m_Threads.size());
+    }
+
+    [[nodiscard]] static uint32_t GetDefaultWorkerCount() noexcept;
+
+  private:
+    struct QueuedTask
+    {
+        Task Work;
+        TaskLatch *pLatch = nullptr;
+    };
+
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex Mutex;
+        std::array<QueuedTask, MAX_QUEUED_TASKS_PER_WORKER> Tasks;
+        size_t Head = 0; // NOTE: Stealing end
+        size_t Tail = 0; // NOTE: Owner end
+    };
+
+  private:
+    void WorkerLoop(uint32_t workerIndex);
+
+    [[nodiscard]] bool TryPush(uint32_t queueIndex, const QueuedTask &task);
+
+    [[nodiscard]] bool TryPopOwn(uint32_t queueIndex, QueuedTask &task);
+
+    [[nodiscard]] bool TrySteal(uint32_t queueIndex, QueuedTask &task);
+
+    [[nodiscard]] bool TryRunOne(uint32_t preferredQueue);
+
+    static void Run(const QueuedTask &task) noexcept;
+
+  private:
+    std::unique_ptr<WorkerQueue[]> m_pQueues;
+    std::vector<std::thread> m_Threads;
+    uint32_t m_QueueCount;
+    std::atomic<uint32_t> m_NextQueue = 0;
+    std::atomic<uint32_t> m_WorkSignal = 0; // NOTE: Bumped on every submit, idle workers wait on it
+    std::atomic<bool> m_Running = true;
+};
+
+} // namespace ae
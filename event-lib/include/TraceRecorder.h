@@ -0,0 +1,97 @@
+#pragma once
+
+#include "EventInstrumentation.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ae
+{
+
+// NOTE: Records dispatches and layer callbacks as timed spans into one preallocated buffer per thread. Writing a span
+// takes no lock, each buffer has a single writer and publishes its count with release ordering. A full buffer drops
+// further spans instead of wrapping, so exporting while recording never reads a span that is being overwritten.
+// Compiled out together with EventInstrumentation
+class TraceRecorder
+{
+  public:
+    static constexpr size_t DEFAULT_SPANS_PER_THREAD = 64 * 1024;
+    static constexpr size_t MAX_SPAN_NAME_LENGTH = 39;
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+    ~TraceRecorder() = default;
+
+    [[nodiscard]] static TraceRecorder &Get() noexcept
+    {
+        static TraceRecorder s_Instance;
+        return s_Instance;
+    }
+
+    // NOTE: Discards previous spans. Start() and Stop() must not race with threads that are still recording
+    void Start(size_t spansPerThread = DEFAULT_SPANS_PER_THREAD);
+
+    void Stop() noexcept;
+
+    [[nodiscard]] bool IsRecording() const noexcept
+    {
+        return m_Recording.load(std::memory_order_relaxed);
+    }
+
+    // NOTE: Names longer than MAX_SPAN_NAME_LENGTH are truncated. The category must be a string literal
+    void RecordSpan(std::string_view name, const char *pCategory, uint64_t startTicks, uint64_t endTicks);
+
+    // NOTE: Span named after the event type. Custom types are named by their id
+    void RecordEventSpan(uint32_t typeId, uint64_t startTicks, uint64_t endTicks);
+
+    // NOTE: Chrome trace event JSON, which chrome://tracing and the Perfetto UI both open
+    void WriteChromeTrace(std::ostream &stream) const;
+
+    bool ExportChromeTrace(const std::string &path) const;
+
+    [[nodiscard]] size_t GetSpanCount() const;
+
+    [[nodiscard]] uint64_t GetDroppedSpanCount() const;
+
+  private:
+    struct Span
+    {
+        uint64_t StartTicks;
+        uint64_t EndTicks;
+        const char *pCategory;
+        char Name[MAX_SPAN_NAME_LENGTH + 1];
+    };
+
+    static_assert(sizeof(Span) == 64, "Span should fill exactly one cache line");
+
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Span[]> pSpans;
+        size_t Capacity = 0;
+        std::atomic<size_t> Count = 0;
+        std::atomic<uint64_t> Dropped = 0;
+        uint32_t ThreadIndex = 0;
+    };
+
+  private:
+    TraceRecorder() = default;
+
+  private:
+    [[nodiscard]] ThreadBuffer &GetThreadBuffer();
+
+  private:
+    mutable std::mutex m_BuffersMutex; // NOTE: Only taken when a thread records its first span, and on export
+    std::vector<std::unique_ptr<ThreadBuffer>> m_Buffers;
+    size_t m_SpansPerThread = DEFAULT_SPANS_PER_THREAD;
+    TimestampCalibration m_Calibration;
+    std::atomic<bool> m_Recording = false;
+};
+
+} // namespace ae
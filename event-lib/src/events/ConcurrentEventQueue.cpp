@@ -0,0 +1,123 @@
+#include "general/pch.h"
+
+#include "ConcurrentEventQueue.h"
+
+#include <bit>
+
+ae::ConcurrentEventQueue::ConcurrentEventQueue(size_t capacity)
+    : m_Capacity(std::bit_ceil(std::max<size_t>(capacity, 2))), m_Mask(m_Capacity - 1)
+{
+    m_pSlots = std::make_unique<Slot[]>(m_Capacity);
+
+    for (size_t i = 0; i < m_Capacity; i++)
+    {
+        m_pSlots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+size_t ae::ConcurrentEventQueue::Drain(EventDelegate dispatch)
+{
+    // NOTE: A nested drain would dispatch and destroy the slot the outer one is still dispatching
+    if (m_Draining)
+    {
+        AE_LOG(AE_WARNING, "Tried to drain ConcurrentEventQueue from inside a drain, the nested drain is ignored");
+        return 0;
+    }
+
+    m_Draining = true;
+
+    size_t head = m_Head.load(std::memory_order_relaxed);
+    const size_t tail = m_Tail.load(std::memory_order_acquire);
+    const size_t depth = tail - head;
+
+    if (depth > m_MaxDepth.load(std::memory_order_relaxed))
+    {
+        m_MaxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    const uint64_t overflowed = m_Overflowed.load(std::memory_order_relaxed);
+
+    if (overflowed != m_ReportedOverflows)
+    {
+        AE_LOG(AE_WARNING, "ConcurrentEventQueue dropped {} posted events since the last drain, capacity is {}",
+               overflowed - m_ReportedOverflows, m_Capacity);
+        m_ReportedOverflows = overflowed;
+    }
+
+    size_t dispatched = 0;
+
+    while (head != tail)
+    {
+        Slot &slot = m_pSlots[head & m_Mask];
+
+        // NOTE: A producer has claimed this slot but not finished writing it yet
+        if (slot.Sequence.load(std::memory_order_acquire) != head + 1)
+        {
+            break;
+        }
+
+        dispatch(slot.Storage.Get());
+        slot.Storage.Reset();
+
+        // NOTE: Hand the slot back to producers for the next lap around the ring
+        slot.Sequence.store(head + m_Capacity, std::memory_order_release);
+        head++;
+        m_Head.store(head, std::memory_order_relaxed);
+        dispatched++;
+    }
+
+    m_Draining = false;
+    return dispatched;
+}
+
+ae::ConcurrentEventQueueStats ae::ConcurrentEventQueue::GetStats() const noexcept
+{
+    const size_t head = m_Head.load(std::memory_order_relaxed);
+    const size_t tail = m_Tail.load(std::memory_order_relaxed);
+
+    return ConcurrentEventQueueStats{
+        .Capacity = m_Capacity,
+        .Depth = tail >= head ? tail - head : 0,
+        .MaxDepth = m_MaxDepth.load(std::memory_order_relaxed),
+        .Posted = m_Posted.load(std::memory_order_relaxed),
+        .Overflowed = m_Overflowed.load(std::memory_order_relaxed),
+    };
+}
+
+ae::ConcurrentEventQueue::Slot *ae::ConcurrentEventQueue::AcquireSlot() noexcept
+{
+    size_t position = m_Tail.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        Slot &slot = m_pSlots[position & m_Mask];
+        const size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0)
+        {
+            if (m_Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                return &slot;
+            }
+        }
+        else if (difference < 0)
+        {
+            // NOTE: The consumer has not released this slot yet, the queue is full
+            m_Overflowed.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+        {
+            position = m_Tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void ae::ConcurrentEventQueue::PublishSlot(Slot *pSlot) noexcept
+{
+    // NOTE: The slot is owned by this producer until the store, so its sequence still equals the claimed position
+    const size_t position = pSlot->Sequence.load(std::memory_order_relaxed);
+    pSlot->Sequence.store(position + 1, std::memory_order_release);
+    m_Posted.fetch_add(1, std::memory_order_relaxed);
+}
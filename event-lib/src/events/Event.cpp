@@ -1,9 +1,57 @@
 #include "general/pch.h"
 
-#include "../internal/events/EventManager.h"
 #include "Event.h"
+#include "EventManager.h"
 
-void ae::Event::Dispatch()
+#include <atomic>
+
+namespace
+{
+
+std::atomic<uint32_t> s_NextCustomEventId = static_cast<uint32_t>(ae::EventType::CUSTOM_START);
+thread_local uint32_t t_DispatchDepth = 0;
+
+} // namespace
+
+void ae::Event::Dispatch(EventPropagation propagation)
+{
+    EventManager::Get().DispatchEvent(*this, propagation);
+}
+
+uint32_t ae::detail::GetNextCustomEventId() noexcept
+{
+    uint32_t id = s_NextCustomEventId.load(std::memory_order_relaxed);
+
+    // NOTE: The counter never moves past the last id, so GetCustomEventTypeCount() stays exact after exhaustion
+    do
+    {
+        if (id > MAX_EVENT_TYPE_ID)
+        {
+            AE_LOG(AE_ERROR, "Ran out of custom event type ids, at most {} custom types are supported",
+                   MAX_EVENT_TYPE_ID - static_cast<uint32_t>(EventType::CUSTOM_START) + 1);
+            return INVALID_EVENT_TYPE_ID;
+        }
+    } while (!s_NextCustomEventId.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+
+    return id;
+}
+
+ae::detail::DispatchScope::DispatchScope() noexcept
+{
+    t_DispatchDepth++;
+}
+
+ae::detail::DispatchScope::~DispatchScope()
+{
+    t_DispatchDepth--;
+}
+
+uint32_t ae::detail::GetDispatchDepth() noexcept
+{
+    return t_DispatchDepth;
+}
+
+uint32_t ae::GetCustomEventTypeCount() noexcept
 {
-    EventManager::Get().DispatchEvent(*this);
+    return s_NextCustomEventId.load(std::memory_order_relaxed) - static_cast<uint32_t>(EventType::CUSTOM_START);
 }
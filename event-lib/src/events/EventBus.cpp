@@ -0,0 +1,915 @@
+#include "general/pch.h"
+
+#include "Event.h"
+#include "EventBus.h"
+#include "EventCoroutine.h"
+#include "EventInstrumentation.h"
+#include "TraceRecorder.h"
+
+#include <cstring>
+
+namespace
+{
+
+// NOTE: Categories only use the low seven bits. The top bit is set on every dispatched event and only
+// stored for unfiltered listeners, so uncategorized events still reach them with a single AND
+constexpr uint8_t UNFILTERED_BIT = 1 << 7;
+constexpr uint8_t UNFILTERED_MASK = 0xFF;
+
+constexpr uint32_t CATCH_ALL_BUCKET = 0;
+
+// NOTE: Marks a dispatch as reading the current table, counted in the epoch it started in. Sequentially consistent,
+// so a writer that sees the counter of the previous epoch drained knows every remaining reader started in the
+// current epoch and loaded a table published since. The epoch check after counting retries a reader that raced
+// with a writer advancing the epoch
+class ReaderScope
+{
+  public:
+    ReaderScope(const std::atomic<uint32_t> &epoch, std::array<std::atomic<uint32_t>, 2> &readers) noexcept
+    {
+        while (true)
+        {
+            const uint32_t readerEpoch = epoch.load(std::memory_order_seq_cst);
+            m_pReaders = &readers[readerEpoch % 2];
+            m_pReaders->fetch_add(1, std::memory_order_seq_cst);
+
+            if (epoch.load(std::memory_order_seq_cst) == readerEpoch)
+            {
+                return;
+            }
+
+            m_pReaders->fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    ReaderScope(const ReaderScope &) = delete;
+    ReaderScope &operator=(const ReaderScope &) = delete;
+    ReaderScope(ReaderScope &&) = delete;
+    ReaderScope &operator=(ReaderScope &&) = delete;
+
+    ~ReaderScope()
+    {
+        m_pReaders->fetch_sub(1, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<uint32_t> *m_pReaders = nullptr;
+};
+
+} // namespace
+
+ae::EventBus::EventBus(std::string name) : EventBus(std::move(name), false)
+{
+}
+
+ae::EventBus::EventBus(std::string name, bool instrumented)
+    : m_Name(std::move(name)), m_Instrumented(instrumented),
+      m_Scheduler(EventDelegate::Bind<&EventBus::DispatchQueuedEvent<EventPropagation::ALL_LISTENERS>>(this), m_Queue)
+{
+    // NOTE: Sized for every type registered so far, types that get their id later grow the table on first listener
+    auto pTable = std::make_unique<DispatchTable>();
+    pTable->Buckets.resize(GetEventTypeCount() + 1);
+    pTable->Buckets[CATCH_ALL_BUCKET] = std::make_shared<const ListenerBucket>();
+    m_pDispatchTable.store(pTable.release(), std::memory_order_release);
+}
+
+ae::EventBus::~EventBus()
+{
+    // NOTE: Their listeners are registered on this bus, so they go before the dispatch table
+    m_pWaitRegistry.reset();
+    m_TimerListener.reset();
+    m_Scheduler.Clear();
+    delete m_pDispatchTable.load(std::memory_order_acquire);
+}
+
+ae::EventBus &ae::EventBus::GetThreadLocal()
+{
+    // NOTE: Only the pointer lives in thread-local storage, so threads that never ask for a bus do not reserve one.
+    // The bus is allocated on the first call and destroyed when the thread exits
+    thread_local std::unique_ptr<EventBus> t_pBus;
+
+    if (t_pBus == nullptr)
+    {
+        t_pBus = std::make_unique<EventBus>("Thread");
+    }
+
+    return *t_pBus;
+}
+
+ae::EventListenerHandle ae::EventBus::AddListener(uint32_t typeId, EventCategoryWrapper categories,
+                                                  std::function<void(Event &)> callback)
+{
+    return AddListener(typeId, categories, EventDelegate(), std::move(callback), nullptr);
+}
+
+ae::EventListenerHandle ae::EventBus::AddListener(uint32_t typeId, EventCategoryWrapper categories,
+                                                  EventDelegate delegate)
+{
+    return AddListener(typeId, categories, delegate, nullptr, nullptr);
+}
+
+ae::EventListenerHandle ae::EventBus::AddBatchListener(uint32_t typeId, detail::BatchCallback callback)
+{
+    if (typeId == static_cast<uint32_t>(EventType::NONE))
+    {
+        AE_LOG(AE_WARNING, "Tried to add a batch EventListener without an event type, batches are always of one type");
+        return EventListenerHandle();
+    }
+
+    return AddListener(typeId, ~EventCategoryWrapper(), EventDelegate(), nullptr, std::move(callback));
+}
+
+ae::EventListenerHandle ae::EventBus::AddListener(uint32_t typeId, EventCategoryWrapper categories,
+                                                  EventDelegate delegate, std::function<void(Event &)> function,
+                                                  detail::BatchCallback batchFunction)
+{
+    if (typeId != static_cast<uint32_t>(EventType::NONE) &&
+        detail::GetEventTypeIndex(typeId) == detail::INVALID_EVENT_TYPE_INDEX)
+    {
+        AE_LOG(AE_WARNING, "Tried to add an EventListener for unknown event type id {}", typeId);
+        return EventListenerHandle();
+    }
+
+    const std::lock_guard lock(m_WriteMutex);
+
+    uint32_t slotIndex = 0;
+
+    if (!m_FreeSlots.empty())
+    {
+        slotIndex = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = m_SlotCount.load(std::memory_order_relaxed);
+
+        if (slotIndex == SLOT_PAGE_SIZE * MAX_SLOT_PAGES)
+        {
+            AE_LOG(AE_ERROR, "Tried to register more than {} EventListeners", SLOT_PAGE_SIZE * MAX_SLOT_PAGES);
+            return EventListenerHandle();
+        }
+
+        if (slotIndex % SLOT_PAGE_SIZE == 0)
+        {
+            m_pSlotPages[slotIndex / SLOT_PAGE_SIZE] = std::make_unique<SlotPage>();
+        }
+
+        m_SlotCount.store(slotIndex + 1, std::memory_order_release);
+    }
+
+    std::unique_ptr<DispatchTable> pTable = CopyDispatchTable();
+    const uint32_t bucketIndex = GetBucketIndex(*pTable, typeId);
+    ListenerBucket &bucket = EditBucket(*pTable, bucketIndex);
+
+    ListenerSlot &slot = GetSlot(slotIndex);
+    slot.BucketIndex = bucketIndex;
+
+    const EventListenerHandle handle{ .Index = slotIndex,
+                                      .Generation = slot.Generation.load(std::memory_order_relaxed) };
+
+    const uint8_t mask = batchFunction ? 0 : GetFilterMask(categories);
+
+    if (function || batchFunction)
+    {
+        slot.pCallbacks = std::make_unique<const ListenerCallbacks>(
+            ListenerCallbacks{ std::move(function), std::move(batchFunction), nullptr });
+    }
+
+    InsertIntoBucket(bucket, EventListener::DEFAULT_PRIORITY, mask, delegate, slot.pCallbacks.get(), handle);
+
+#ifdef AE_EVENT_INSTRUMENTATION
+    static_assert(SLOT_PAGE_SIZE * MAX_SLOT_PAGES <=
+                      EventInstrumentation::LISTENER_PAGE_SIZE * EventInstrumentation::MAX_LISTENER_PAGES,
+                  "Every slot needs listener counters");
+
+    // NOTE: Before publishing, so a dispatch on another thread that finds the listener also finds its counters
+    if (m_Instrumented)
+    {
+        EventInstrumentation::Get().OnListenerAdded(handle, typeId);
+    }
+#endif
+
+    PublishDispatchTable(std::move(pTable));
+
+    return handle;
+}
+
+void ae::EventBus::RemoveListener(EventListenerHandle handle)
+{
+    const std::lock_guard lock(m_WriteMutex);
+
+    ListenerSlot *pSlot = FindSlot(handle);
+
+    if (pSlot == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Tried to remove EventListener from EventBus that was not registered. "
+                           "This should not be possible and may be due to a library bug");
+        return;
+    }
+
+    std::unique_ptr<DispatchTable> pTable = CopyDispatchTable();
+    ListenerBucket &bucket = EditBucket(*pTable, pSlot->BucketIndex);
+
+    EraseFromBucket(bucket, pSlot->DenseIndex);
+
+    // NOTE: Invalidates any remaining copies of the handle, and stops a dispatch still reading an older table from
+    // calling the listener
+    pSlot->Generation.fetch_add(1, std::memory_order_release);
+    m_FreeSlots.push_back(handle.Index);
+
+    PublishDispatchTable(std::move(pTable), std::move(pSlot->pCallbacks));
+}
+
+void ae::EventBus::SetListenerCallback(EventListenerHandle handle, std::function<void(Event &)> callback)
+{
+    const std::lock_guard lock(m_WriteMutex);
+
+    ListenerSlot *pSlot = FindSlot(handle);
+
+    if (pSlot == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Tried to set callback of EventListener that is not registered in EventBus");
+        return;
+    }
+
+    std::unique_ptr<DispatchTable> pTable = CopyDispatchTable();
+    ListenerBucket &bucket = EditBucket(*pTable, pSlot->BucketIndex);
+    bucket.Delegates[pSlot->DenseIndex] = EventDelegate();
+
+    ListenerCallbacks callbacks = pSlot->pCallbacks != nullptr ? *pSlot->pCallbacks : ListenerCallbacks();
+    callbacks.Function = std::move(callback);
+
+    PublishDispatchTable(std::move(pTable), ReplaceCallbacks(*pSlot, bucket, std::move(callbacks)));
+}
+
+void ae::EventBus::SetListenerCallback(EventListenerHandle handle, EventDelegate delegate)
+{
+    const std::lock_guard lock(m_WriteMutex);
+
+    ListenerSlot *pSlot = FindSlot(handle);
+
+    if (pSlot == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Tried to set callback of EventListener that is not registered in EventBus");
+        return;
+    }
+
+    std::unique_ptr<DispatchTable> pTable = CopyDispatchTable();
+    ListenerBucket &bucket = EditBucket(*pTable, pSlot->BucketIndex);
+    bucket.Delegates[pSlot->DenseIndex] = delegate;
+
+    ListenerCallbacks callbacks = pSlot->pCallbacks != nullptr ? *pSlot->pCallbacks : ListenerCallbacks();
+    callbacks.Function = nullptr;
+
+    PublishDispatchTable(std::move(pTable), ReplaceCallbacks(*pSlot, bucket, std::move(callbacks)));
+}
+
+void ae::EventBus::SetListenerCategoryMask(EventListenerHandle handle, EventCategoryWrapper categories)
+{
+    const std::lock_guard lock(m_WriteMutex);
+
+    ListenerSlot *pSlot = FindSlot(handle);
+
+    if (pSlot == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Tried to set category mask of EventListener that is not registered in EventBus");
+        return;
+    }
+
+    std::unique_ptr<DispatchTable> pTable = CopyDispatchTable();
+    EditBucket(*pTable, pSlot->BucketIndex).Masks[pSlot->DenseIndex] = GetFilterMask(categories);
+
+    PublishDispatchTable(std::move(pTable));
+}
+
+void ae::EventBus::SetListenerPriority(EventListenerHandle handle, int32_t priority)
+{
+    const std::lock_guard lock(m_WriteMutex);
+
+    ListenerSlot *pSlot = FindSlot(handle);
+
+    if (pSlot == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Tried to set priority of EventListener that is not registered in EventBus");
+        return;
+    }
+
+    std::unique_ptr<DispatchTable> pTable = CopyDispatchTable();
+    ListenerBucket &bucket = EditBucket(*pTable, pSlot->BucketIndex);
+    const uint32_t denseIndex = pSlot->DenseIndex;
+
+    const uint8_t mask = bucket.Masks[denseIndex];
+    const EventDelegate delegate = bucket.Delegates[denseIndex];
+
+    EraseFromBucket(bucket, denseIndex);
+    InsertIntoBucket(bucket, priority, mask, delegate, pSlot->pCallbacks.get(), handle);
+
+    PublishDispatchTable(std::move(pTable));
+}
+
+void ae::EventBus::SetListenerThrottle(EventListenerHandle handle, const EventThrottle &throttle)
+{
+    const std::lock_guard lock(m_WriteMutex);
+
+    ListenerSlot *pSlot = FindSlot(handle);
+
+    if (pSlot == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Tried to set throttle of EventListener that is not registered in EventBus");
+        return;
+    }
+
+    std::unique_ptr<DispatchTable> pTable = CopyDispatchTable();
+    ListenerBucket &bucket = EditBucket(*pTable, pSlot->BucketIndex);
+
+    // NOTE: A trailing event of the replaced state is dropped with it, Flush() skips states that lost their listener
+    ListenerCallbacks callbacks = pSlot->pCallbacks != nullptr ? *pSlot->pCallbacks : ListenerCallbacks();
+    callbacks.pThrottle = throttle.IsActive() ? std::make_shared<ThrottleState>(throttle) : nullptr;
+
+    PublishDispatchTable(std::move(pTable), ReplaceCallbacks(*pSlot, bucket, std::move(callbacks)));
+}
+
+void ae::EventBus::Flush(EventPropagation propagation)
+{
+    if (m_Flushing)
+    {
+        AE_LOG(AE_WARNING, "Tried to flush EventBus '{}' from inside a flush, the nested flush is ignored", m_Name);
+        return;
+    }
+
+    m_Flushing = true;
+
+    const EventDelegate dispatch =
+        propagation == EventPropagation::STOP_ON_CONSUME
+            ? EventDelegate::Bind<&EventBus::DispatchQueuedEvent<EventPropagation::STOP_ON_CONSUME>>(this)
+            : EventDelegate::Bind<&EventBus::DispatchQueuedEvent<EventPropagation::ALL_LISTENERS>>(this);
+
+    m_PostQueue.Drain(dispatch);
+
+    // NOTE: Payloads allocated by listeners during the flush belong to events for the next flush
+    FrameArena &arena = m_FrameArenas[m_FrameArenaIndex];
+    m_FrameArenaIndex ^= 1;
+
+    m_Queue.Flush(dispatch);
+    arena.Reset();
+
+    DeliverTrailingEvents();
+    m_Flushing = false;
+
+    // NOTE: Tables replaced by listeners registered during the flush could not be freed while it was dispatching
+    const std::lock_guard lock(m_WriteMutex);
+    ReclaimDispatchTables();
+}
+
+void ae::EventBus::EnableTimers()
+{
+    if (!m_TimerListener.has_value())
+    {
+        // NOTE: Ahead of user listeners, so timers due this frame fire before the frame's update listeners run
+        m_TimerListener.emplace(EventListener::For<UpdateEvent>(*this, EventDelegate::Bind<&EventBus::OnUpdate>(this)));
+        m_TimerListener->SetPriority(TIMER_PRIORITY);
+    }
+}
+
+void ae::EventBus::OnUpdate(UpdateEvent &event)
+{
+    m_Scheduler.Advance(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(event.GetDeltaTime())));
+}
+
+ae::detail::EventWaitRegistry &ae::EventBus::GetWaitRegistry()
+{
+    if (m_pWaitRegistry == nullptr)
+    {
+        m_pWaitRegistry = std::make_unique<detail::EventWaitRegistry>(*this);
+    }
+
+    return *m_pWaitRegistry;
+}
+
+bool ae::EventBus::IsListenerValid(EventListenerHandle handle) const noexcept
+{
+    return handle.Index < m_SlotCount.load(std::memory_order_acquire) &&
+           GetSlot(handle.Index).Generation.load(std::memory_order_acquire) == handle.Generation;
+}
+
+void ae::EventBus::DispatchEvent(Event &event, EventPropagation propagation) const
+{
+    const detail::DispatchScope dispatchScope;
+    const ReaderScope reader(m_ReaderEpoch, m_ActiveReaders);
+    const DispatchTable &table = *m_pDispatchTable.load(std::memory_order_seq_cst);
+
+    // NOTE: Listeners subscribed to the event type first, then catch-all listeners
+    // NOTE: An invalid index wraps to the catch-all bucket, which is skipped here and dispatched after the typed one
+    const uint32_t bucketIndex = detail::GetEventTypeIndex(event.GetTypeId()) + 1;
+    const bool hasBucket = bucketIndex != CATCH_ALL_BUCKET && bucketIndex < table.Buckets.size();
+    const ListenerBucket *pTypedBucket = hasBucket ? table.Buckets[bucketIndex].get() : nullptr;
+
+#ifdef AE_EVENT_INSTRUMENTATION
+    EventInstrumentation &instrumentation = EventInstrumentation::Get();
+    TraceRecorder &traceRecorder = TraceRecorder::Get();
+
+    // NOTE: Statistics are single-threaded and indexed by slot, so only the global bus records them. Traces are
+    // per thread and cover every bus
+    const bool instrumented = m_Instrumented && instrumentation.IsEnabled();
+
+    if (instrumented || traceRecorder.IsRecording())
+    {
+        const uint64_t start = EventInstrumentation::ReadTimestamp();
+        const bool consumed = instrumented ? DispatchToBuckets<true>(table, pTypedBucket, event, propagation)
+                                           : DispatchToBuckets<false>(table, pTypedBucket, event, propagation);
+        const uint64_t end = EventInstrumentation::ReadTimestamp();
+
+        if (instrumented)
+        {
+            instrumentation.RecordDispatch(event.GetTypeId(), consumed, end - start);
+        }
+
+        if (traceRecorder.IsRecording())
+        {
+            traceRecorder.RecordEventSpan(event.GetTypeId(), start, end);
+        }
+
+        return;
+    }
+#endif
+
+    DispatchToBuckets<false>(table, pTypedBucket, event, propagation);
+}
+
+bool ae::EventBus::DispatchToBatchListeners(uint32_t typeId, const void *pEvents, size_t count) const
+{
+    const detail::DispatchScope dispatchScope;
+    const ReaderScope reader(m_ReaderEpoch, m_ActiveReaders);
+    const DispatchTable &table = *m_pDispatchTable.load(std::memory_order_seq_cst);
+
+    const bool hasCatchAllListeners = !table.Buckets[CATCH_ALL_BUCKET]->Handles.empty();
+    const uint32_t bucketIndex = detail::GetEventTypeIndex(typeId) + 1;
+
+    if (bucketIndex == CATCH_ALL_BUCKET || bucketIndex >= table.Buckets.size() ||
+        table.Buckets[bucketIndex] == nullptr)
+    {
+        return hasCatchAllListeners;
+    }
+
+    const ListenerBucket &bucket = *table.Buckets[bucketIndex];
+
+#ifdef AE_EVENT_INSTRUMENTATION
+    const bool instrumented = m_Instrumented && EventInstrumentation::Get().IsEnabled();
+#endif
+
+    // NOTE: Types without batch listeners, the common case, skip the scan
+    const size_t scanCount = bucket.BatchCount != 0 ? bucket.Callbacks.size() : 0;
+
+    for (size_t i = 0; i < scanCount; i++)
+    {
+        const ListenerCallbacks *pCallbacks = bucket.Callbacks[i];
+        const EventListenerHandle handle = bucket.Handles[i];
+
+        // NOTE: Same check as for single events, a listener removed during the batch is not called
+        if (pCallbacks == nullptr || !pCallbacks->BatchFunction ||
+            (m_pDispatchTable.load(std::memory_order_acquire) != &table &&
+             GetSlot(handle.Index).Generation.load(std::memory_order_acquire) != handle.Generation))
+        {
+            continue;
+        }
+
+        const detail::BatchCallback &batchFunction = pCallbacks->BatchFunction;
+
+#ifdef AE_EVENT_INSTRUMENTATION
+        if (instrumented)
+        {
+            const uint64_t start = EventInstrumentation::ReadTimestamp();
+            batchFunction(pEvents, count);
+            const uint64_t ticks = EventInstrumentation::ReadTimestamp() - start;
+            EventInstrumentation::Get().RecordListener(handle.Index, false, ticks);
+            continue;
+        }
+#endif
+
+        batchFunction(pEvents, count);
+    }
+
+    return hasCatchAllListeners || bucket.Handles.size() > bucket.BatchCount;
+}
+
+template <bool Instrumented>
+bool ae::EventBus::DispatchToBuckets(const DispatchTable &table, const ListenerBucket *pTypedBucket, Event &event,
+                                     EventPropagation propagation) const
+{
+    const uint8_t eventBits = event.GetCategory().GetValue() | UNFILTERED_BIT;
+    const ListenerBucket &catchAllBucket = *table.Buckets[CATCH_ALL_BUCKET];
+    const bool stopOnConsume = propagation == EventPropagation::STOP_ON_CONSUME;
+
+    if (stopOnConsume)
+    {
+        event.m_Consumed = false;
+    }
+
+    // NOTE: When every typed listener ranks at or above every catch-all listener, which covers the common case of
+    // default priorities, the buckets run one after the other with the packed mask filter
+    if (pTypedBucket == nullptr || pTypedBucket->Priorities.empty() || catchAllBucket.Priorities.empty() ||
+        pTypedBucket->Priorities.back() >= catchAllBucket.Priorities.front())
+    {
+        bool consumed = pTypedBucket != nullptr &&
+                        DispatchToBucket<Instrumented>(table, *pTypedBucket, eventBits, event, propagation);
+
+        if (consumed && stopOnConsume)
+        {
+            return true;
+        }
+
+        consumed |= DispatchToBucket<Instrumented>(table, catchAllBucket, eventBits, event, propagation);
+        return consumed;
+    }
+
+    // NOTE: Otherwise merge the two sorted buckets, typed listeners first among equal priorities
+    const ListenerBucket &typedBucket = *pTypedBucket;
+    const size_t typedCount = typedBucket.Priorities.size();
+    const size_t catchAllCount = catchAllBucket.Priorities.size();
+    size_t typedIndex = 0;
+    size_t catchAllIndex = 0;
+    bool consumed = false;
+
+    while (typedIndex < typedCount || catchAllIndex < catchAllCount)
+    {
+        const bool fromTyped = catchAllIndex == catchAllCount ||
+                               (typedIndex < typedCount &&
+                                typedBucket.Priorities[typedIndex] >= catchAllBucket.Priorities[catchAllIndex]);
+        const ListenerBucket &bucket = fromTyped ? typedBucket : catchAllBucket;
+        const size_t index = fromTyped ? typedIndex++ : catchAllIndex++;
+
+        if ((bucket.Masks[index] & eventBits) != 0 &&
+            DispatchToListener<Instrumented>(table, bucket, index, event, propagation))
+        {
+            consumed = true;
+
+            if (stopOnConsume)
+            {
+                break;
+            }
+        }
+    }
+
+    return consumed;
+}
+
+ae::EventBus::ListenerSlot *ae::EventBus::FindSlot(EventListenerHandle handle) noexcept
+{
+    if (!IsListenerValid(handle))
+    {
+        return nullptr;
+    }
+
+    return &GetSlot(handle.Index);
+}
+
+std::unique_ptr<ae::EventBus::DispatchTable> ae::EventBus::CopyDispatchTable() const
+{
+    return std::make_unique<DispatchTable>(*m_pDispatchTable.load(std::memory_order_relaxed));
+}
+
+uint32_t ae::EventBus::GetBucketIndex(DispatchTable &table, uint32_t typeId)
+{
+    if (typeId == static_cast<uint32_t>(EventType::NONE))
+    {
+        return CATCH_ALL_BUCKET;
+    }
+
+    // NOTE: Buckets follow the dense type index, shifted by one for the catch-all bucket
+    const uint32_t bucketIndex = detail::GetEventTypeIndex(typeId) + 1;
+
+    if (bucketIndex >= table.Buckets.size())
+    {
+        table.Buckets.resize(std::max(bucketIndex + 1, GetEventTypeCount() + 1));
+    }
+
+    return bucketIndex;
+}
+
+ae::EventBus::ListenerBucket &ae::EventBus::EditBucket(DispatchTable &table, uint32_t bucketIndex)
+{
+    static_assert(std::is_trivially_copyable_v<EventDelegate> && std::is_trivially_copyable_v<EventListenerHandle>,
+                  "Bucket copies are memory copies, so listener state that is not trivially copyable belongs in "
+                  "ListenerCallbacks");
+
+    // NOTE: The published bucket may still be read by a dispatch, so the new table gets its own copy
+    const std::shared_ptr<const ListenerBucket> &pPublished = table.Buckets[bucketIndex];
+    auto pBucket =
+        pPublished != nullptr ? std::make_shared<ListenerBucket>(*pPublished) : std::make_shared<ListenerBucket>();
+    ListenerBucket &bucket = *pBucket;
+    table.Buckets[bucketIndex] = std::move(pBucket);
+    return bucket;
+}
+
+uint32_t ae::EventBus::InsertIntoBucket(ListenerBucket &bucket, int32_t priority, uint8_t mask, EventDelegate delegate,
+                                        const ListenerCallbacks *pCallbacks, EventListenerHandle handle)
+{
+    // NOTE: After every listener of equal or higher priority, so equal priorities keep their registration order
+    const auto it = std::ranges::upper_bound(bucket.Priorities, priority, std::greater<>());
+    const auto offset = it - bucket.Priorities.begin();
+
+    bucket.Priorities.insert(it, priority);
+    bucket.Masks.insert(bucket.Masks.begin() + offset, mask);
+    bucket.Delegates.insert(bucket.Delegates.begin() + offset, delegate);
+    bucket.Callbacks.insert(bucket.Callbacks.begin() + offset, pCallbacks);
+    bucket.Handles.insert(bucket.Handles.begin() + offset, handle);
+    bucket.BatchCount += pCallbacks != nullptr && pCallbacks->BatchFunction ? 1 : 0;
+    bucket.ThrottleCount += pCallbacks != nullptr && pCallbacks->pThrottle != nullptr ? 1 : 0;
+
+    const auto denseIndex = static_cast<uint32_t>(offset);
+    UpdateDenseIndices(bucket, denseIndex);
+    return denseIndex;
+}
+
+void ae::EventBus::EraseFromBucket(ListenerBucket &bucket, uint32_t denseIndex)
+{
+    bucket.Priorities.erase(bucket.Priorities.begin() + denseIndex);
+    bucket.Masks.erase(bucket.Masks.begin() + denseIndex);
+    bucket.Delegates.erase(bucket.Delegates.begin() + denseIndex);
+
+    const ListenerCallbacks *pCallbacks = bucket.Callbacks[denseIndex];
+    bucket.BatchCount -= pCallbacks != nullptr && pCallbacks->BatchFunction ? 1 : 0;
+    bucket.ThrottleCount -= pCallbacks != nullptr && pCallbacks->pThrottle != nullptr ? 1 : 0;
+    bucket.Callbacks.erase(bucket.Callbacks.begin() + denseIndex);
+
+    bucket.Handles.erase(bucket.Handles.begin() + denseIndex);
+
+    UpdateDenseIndices(bucket, denseIndex);
+}
+
+void ae::EventBus::UpdateDenseIndices(const ListenerBucket &bucket, uint32_t begin)
+{
+    for (uint32_t i = begin; i < bucket.Handles.size(); i++)
+    {
+        GetSlot(bucket.Handles[i].Index).DenseIndex = i;
+    }
+}
+
+std::unique_ptr<const ae::EventBus::ListenerCallbacks>
+ae::EventBus::ReplaceCallbacks(ListenerSlot &slot, ListenerBucket &bucket, ListenerCallbacks callbacks)
+{
+    std::unique_ptr<const ListenerCallbacks> pOldCallbacks = std::move(slot.pCallbacks);
+
+    if (callbacks.Function || callbacks.BatchFunction || callbacks.pThrottle != nullptr)
+    {
+        slot.pCallbacks = std::make_unique<const ListenerCallbacks>(std::move(callbacks));
+    }
+
+    const ListenerCallbacks *pNewCallbacks = slot.pCallbacks.get();
+    bucket.BatchCount -= pOldCallbacks != nullptr && pOldCallbacks->BatchFunction ? 1 : 0;
+    bucket.BatchCount += pNewCallbacks != nullptr && pNewCallbacks->BatchFunction ? 1 : 0;
+    bucket.ThrottleCount -= pOldCallbacks != nullptr && pOldCallbacks->pThrottle != nullptr ? 1 : 0;
+    bucket.ThrottleCount += pNewCallbacks != nullptr && pNewCallbacks->pThrottle != nullptr ? 1 : 0;
+    bucket.Callbacks[slot.DenseIndex] = pNewCallbacks;
+
+    return pOldCallbacks;
+}
+
+void ae::EventBus::PublishDispatchTable(std::unique_ptr<DispatchTable> pTable,
+                                        std::unique_ptr<const ListenerCallbacks> pRetiredCallbacks)
+{
+    const DispatchTable *pOldTable = m_pDispatchTable.exchange(pTable.release(), std::memory_order_seq_cst);
+    m_RetiredTables.push_back(RetiredTable{ .pTable = std::unique_ptr<const DispatchTable>(pOldTable),
+                                            .pCallbacks = std::move(pRetiredCallbacks),
+                                            .Epoch = m_ReaderEpoch.load(std::memory_order_relaxed) });
+    ReclaimDispatchTables();
+}
+
+void ae::EventBus::ReclaimDispatchTables()
+{
+    // NOTE: Twice, so a bus without readers frees its last write right away instead of on the next one
+    for (uint32_t step = 0; step < 2 && !m_RetiredTables.empty(); step++)
+    {
+        const uint32_t epoch = m_ReaderEpoch.load(std::memory_order_relaxed);
+
+        // NOTE: Readers of the previous epoch may still hold any table retired before this one began
+        if (m_ActiveReaders[(epoch + 1) % 2].load(std::memory_order_seq_cst) != 0)
+        {
+            return;
+        }
+
+        // NOTE: Every remaining reader loaded its table after the epoch advanced, so older retirees are unreachable
+        std::erase_if(m_RetiredTables, [epoch](const RetiredTable &retired) { return retired.Epoch != epoch; });
+        m_ReaderEpoch.store(epoch + 1, std::memory_order_seq_cst);
+    }
+}
+
+uint8_t ae::EventBus::GetFilterMask(EventCategoryWrapper categories) noexcept
+{
+    if (categories == ~EventCategoryWrapper())
+    {
+        return UNFILTERED_MASK;
+    }
+
+    return static_cast<uint8_t>(categories.GetValue() & ~UNFILTERED_BIT);
+}
+
+template <bool Instrumented>
+bool ae::EventBus::DispatchToBucket(const DispatchTable &table, const ListenerBucket &bucket, uint8_t eventBits,
+                                    Event &event, EventPropagation propagation) const
+{
+    const size_t count = bucket.Masks.size();
+    const bool stopOnConsume = propagation == EventPropagation::STOP_ON_CONSUME;
+    bool consumed = false;
+
+    // NOTE: At the start of each group of eight, test their packed masks at once and skip the group when none match.
+    // A single call site keeps the listener call inlined
+    const uint64_t eventBitsWide = 0x0101010101010101ULL * eventBits;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i % 8 == 0 && i + 8 <= count)
+        {
+            uint64_t masks = 0;
+            std::memcpy(&masks, bucket.Masks.data() + i, sizeof(masks));
+
+            if ((masks & eventBitsWide) == 0)
+            {
+                i += 7;
+                continue;
+            }
+        }
+
+        if ((bucket.Masks[i] & eventBits) != 0 &&
+            DispatchToListener<Instrumented>(table, bucket, i, event, propagation))
+        {
+            consumed = true;
+
+            if (stopOnConsume)
+            {
+                return true;
+            }
+        }
+    }
+
+    return consumed;
+}
+
+template <bool Instrumented>
+inline bool ae::EventBus::DispatchToListener(const DispatchTable &table, const ListenerBucket &bucket, size_t index,
+                                             Event &event, EventPropagation propagation) const
+{
+    // NOTE: Once a newer table is published this one may hold listeners that have since been removed. Checking the
+    // table pointer first keeps the generation lookup off the common path
+    const EventListenerHandle handle = bucket.Handles[index];
+
+    if (m_pDispatchTable.load(std::memory_order_acquire) != &table &&
+        GetSlot(handle.Index).Generation.load(std::memory_order_acquire) != handle.Generation)
+    {
+        return false;
+    }
+
+    const EventDelegate &delegate = bucket.Delegates[index];
+    const ListenerCallbacks *pCallbacks = bucket.Callbacks[index];
+
+    if (!delegate && (pCallbacks == nullptr || !pCallbacks->Function))
+    {
+        return false;
+    }
+
+    // NOTE: Without propagation control every listener gets a non-consumed event
+    if (propagation == EventPropagation::ALL_LISTENERS)
+    {
+        event.m_Consumed = false;
+    }
+
+    // NOTE: The count keeps buckets without throttled listeners from touching the callbacks of delegates
+    if (bucket.ThrottleCount != 0 && pCallbacks != nullptr && pCallbacks->pThrottle != nullptr &&
+        !PassThrottle(pCallbacks->pThrottle, event))
+    {
+        return false;
+    }
+
+    [[maybe_unused]] uint64_t start = 0;
+
+    if constexpr (Instrumented)
+    {
+        start = EventInstrumentation::ReadTimestamp();
+    }
+
+    if (delegate)
+    {
+        delegate(event);
+    }
+    else
+    {
+        pCallbacks->Function(event);
+    }
+
+    if constexpr (Instrumented)
+    {
+        const uint64_t ticks = EventInstrumentation::ReadTimestamp() - start;
+        EventInstrumentation::Get().RecordListener(handle.Index, event.m_Consumed, ticks);
+    }
+
+    return event.m_Consumed;
+}
+
+bool ae::EventBus::PassThrottle(const std::shared_ptr<ThrottleState> &pState, const Event &event) const
+{
+    ThrottleState &state = *pState;
+    const EventThrottle &throttle = state.Throttle;
+
+    if (throttle.SampleEvery > 1)
+    {
+        const bool sampled = state.SampleCounter == 0;
+        state.SampleCounter = (state.SampleCounter + 1) % throttle.SampleEvery;
+
+        if (!sampled)
+        {
+            return false;
+        }
+    }
+
+    if (throttle.MinInterval.count() <= 0)
+    {
+        return true;
+    }
+
+    // NOTE: Monotonic and read through the vDSO, so no system call. Only throttled listeners read it
+    const auto now = std::chrono::steady_clock::now();
+
+    if (state.HasDelivered && now - state.LastDelivery < throttle.MinInterval)
+    {
+        if (throttle.pTrailing != nullptr)
+        {
+            throttle.pTrailing->pStore(state.Trailing, event);
+
+            if (!state.TrailingQueued)
+            {
+                state.TrailingQueued = true;
+                m_TrailingThrottles.push_back(pState);
+            }
+        }
+
+        return false;
+    }
+
+    // NOTE: The event getting through is newer than any stored one
+    state.Trailing.Reset();
+    state.LastDelivery = now;
+    state.HasDelivered = true;
+    return true;
+}
+
+void ae::EventBus::DeliverTrailingEvents()
+{
+    if (m_TrailingThrottles.empty())
+    {
+        return;
+    }
+
+    std::swap(m_TrailingThrottles, m_DeliveringThrottles);
+    const auto now = std::chrono::steady_clock::now();
+
+    // NOTE: A delivery stands in for a dispatch that happened earlier, so whatever it causes counts as nested
+    const detail::DispatchScope dispatchScope;
+    const ReaderScope readerScope(m_ReaderEpoch, m_ActiveReaders);
+    const DispatchTable &table = *m_pDispatchTable.load(std::memory_order_acquire);
+
+    for (std::shared_ptr<ThrottleState> &pState : m_DeliveringThrottles)
+    {
+        ThrottleState &state = *pState;
+
+        if (!state.Trailing.HasValue())
+        {
+            state.TrailingQueued = false;
+            continue;
+        }
+
+        if (now - state.LastDelivery < state.Throttle.MinInterval)
+        {
+            m_TrailingThrottles.push_back(std::move(pState));
+            continue;
+        }
+
+        state.TrailingQueued = false;
+        state.LastDelivery = now;
+
+        // NOTE: Trailing throttles only go on typed listeners. The state is no longer in its type's bucket once the
+        // listener was removed or given a new throttle, and the stored event is dropped
+        const detail::TrailingEventOps &ops = *state.Throttle.pTrailing;
+        const uint32_t bucketIndex = detail::GetEventTypeIndex(ops.pGetTypeId()) + 1;
+        const ListenerBucket *pBucket = bucketIndex < table.Buckets.size() ? table.Buckets[bucketIndex].get() : nullptr;
+        size_t index = 0;
+
+        if (pBucket != nullptr)
+        {
+            const auto it = std::ranges::find_if(pBucket->Callbacks, [&pState](const ListenerCallbacks *pCallbacks)
+                                                 { return pCallbacks != nullptr && pCallbacks->pThrottle == pState; });
+            index = static_cast<size_t>(it - pBucket->Callbacks.begin());
+        }
+
+        if (pBucket == nullptr || index == pBucket->Callbacks.size() ||
+            (!pBucket->Delegates[index] && !pBucket->Callbacks[index]->Function))
+        {
+            state.Trailing.Reset();
+            continue;
+        }
+
+        ops.pDeliver(state.Trailing, pBucket->Delegates[index], pBucket->Callbacks[index]->Function);
+    }
+
+    m_DeliveringThrottles.clear();
+}
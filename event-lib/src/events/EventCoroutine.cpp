@@ -0,0 +1,197 @@
+#include "general/pch.h"
+
+#include "EventCoroutine.h"
+
+#include <array>
+#include <new>
+
+namespace
+{
+
+constexpr size_t SIZE_CLASS_COUNT =
+    ae::detail::MAX_POOLED_COROUTINE_FRAME_SIZE / ae::detail::COROUTINE_FRAME_SIZE_CLASS;
+
+struct FreeFrame
+{
+    FreeFrame *pNext;
+};
+
+class CoroutineFramePool
+{
+  public:
+    CoroutineFramePool() = default;
+    CoroutineFramePool(const CoroutineFramePool &) = delete;
+    CoroutineFramePool &operator=(const CoroutineFramePool &) = delete;
+
+    ~CoroutineFramePool()
+    {
+        for (FreeFrame *pFrame : m_pFreeLists)
+        {
+            while (pFrame != nullptr)
+            {
+                FreeFrame *pNext = pFrame->pNext;
+                ::operator delete(pFrame);
+                pFrame = pNext;
+            }
+        }
+    }
+
+    [[nodiscard]] void *Allocate(size_t sizeClass)
+    {
+        FreeFrame *&pFreeList = m_pFreeLists[sizeClass];
+
+        if (pFreeList == nullptr)
+        {
+            return ::operator new((sizeClass + 1) * ae::detail::COROUTINE_FRAME_SIZE_CLASS);
+        }
+
+        FreeFrame *pFrame = pFreeList;
+        pFreeList = pFrame->pNext;
+        return pFrame;
+    }
+
+    void Free(void *pFrame, size_t sizeClass) noexcept
+    {
+        auto *pFreeFrame = static_cast<FreeFrame *>(pFrame);
+        pFreeFrame->pNext = m_pFreeLists[sizeClass];
+        m_pFreeLists[sizeClass] = pFreeFrame;
+    }
+
+  private:
+    std::array<FreeFrame *, SIZE_CLASS_COUNT> m_pFreeLists{};
+};
+
+thread_local CoroutineFramePool t_FramePool;
+
+[[nodiscard]] size_t GetSizeClass(size_t size) noexcept
+{
+    return (std::max<size_t>(size, 1) - 1) / ae::detail::COROUTINE_FRAME_SIZE_CLASS;
+}
+
+} // namespace
+
+void *ae::detail::AllocateCoroutineFrame(size_t size)
+{
+    if (size > MAX_POOLED_COROUTINE_FRAME_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    return t_FramePool.Allocate(GetSizeClass(size));
+}
+
+void ae::detail::FreeCoroutineFrame(void *pFrame, size_t size) noexcept
+{
+    if (size > MAX_POOLED_COROUTINE_FRAME_SIZE)
+    {
+        ::operator delete(pFrame);
+        return;
+    }
+
+    t_FramePool.Free(pFrame, GetSizeClass(size));
+}
+
+void ae::detail::EventWaitRegistry::Add(uint32_t typeId, const EventWaiter &waiter)
+{
+    const uint32_t typeIndex = GetEventTypeIndex(typeId);
+
+    if (typeIndex == INVALID_EVENT_TYPE_INDEX)
+    {
+        AE_LOG(AE_ERROR, "Tried to wait for unknown event type id {}, the coroutine is never resumed", typeId);
+        return;
+    }
+
+    if (typeIndex >= m_Types.size())
+    {
+        m_Types.resize(std::max(typeIndex + 1, GetEventTypeCount()));
+    }
+
+    TypeWaiters &type = m_Types[typeIndex];
+    type.Waiters.push_back(waiter);
+
+    if (!type.Listener.has_value())
+    {
+        // NOTE: Ahead of user listeners, so a waiting coroutine sees the event before one can consume it
+        type.Listener.emplace(m_Bus, typeId, [this, typeIndex](Event &event) { OnEvent(typeIndex, event); });
+        type.Listener->SetPriority(EventBus::COROUTINE_PRIORITY);
+    }
+}
+
+void ae::detail::EventWaitRegistry::Remove(uint32_t typeId, const void *pAwaiter) noexcept
+{
+    const uint32_t typeIndex = GetEventTypeIndex(typeId);
+
+    if (typeIndex >= m_Types.size())
+    {
+        return;
+    }
+
+    TypeWaiters &type = m_Types[typeIndex];
+    const auto it = std::ranges::find(type.Waiters, pAwaiter, &EventWaiter::pAwaiter);
+
+    if (it != type.Waiters.end())
+    {
+        type.Waiters.erase(it);
+        return;
+    }
+
+    // NOTE: The awaiter was destroyed by a coroutine resumed from the same dispatch, which skips the cleared entry
+    for (std::vector<EventWaiter> *pInFlight : type.InFlight)
+    {
+        const auto inFlightIt = std::ranges::find(*pInFlight, pAwaiter, &EventWaiter::pAwaiter);
+
+        if (inFlightIt != pInFlight->end())
+        {
+            inFlightIt->pAwaiter = nullptr;
+            return;
+        }
+    }
+}
+
+size_t ae::detail::EventWaitRegistry::GetWaiterCount() const noexcept
+{
+    size_t count = 0;
+
+    for (const TypeWaiters &type : m_Types)
+    {
+        count += type.Waiters.size();
+
+        for (const std::vector<EventWaiter> *pInFlight : type.InFlight)
+        {
+            count += static_cast<size_t>(std::ranges::count_if(
+                *pInFlight, [](const EventWaiter &waiter) { return waiter.pAwaiter != nullptr; }));
+        }
+    }
+
+    return count;
+}
+
+void ae::detail::EventWaitRegistry::OnEvent(uint32_t typeIndex, Event &event)
+{
+    // NOTE: The list is taken out first, so coroutines that wait again after resuming only see the next event
+    std::vector<EventWaiter> waiters = std::move(m_Types[typeIndex].Waiters);
+    m_Types[typeIndex].Waiters.clear();
+    m_Types[typeIndex].InFlight.push_back(&waiters);
+
+    for (EventWaiter &waiter : waiters)
+    {
+        if (waiter.pAwaiter != nullptr && waiter.pTryMatch(waiter.pAwaiter, event))
+        {
+            waiter.pAwaiter = nullptr;
+            waiter.Handle.resume();
+        }
+    }
+
+    // NOTE: Resumed coroutines may have added waiters and grown m_Types, so it is indexed again
+    TypeWaiters &type = m_Types[typeIndex];
+    type.InFlight.pop_back();
+
+    std::erase_if(waiters, [](const EventWaiter &waiter) { return waiter.pAwaiter == nullptr; });
+    type.Waiters.insert(type.Waiters.begin(), waiters.begin(), waiters.end());
+
+    // NOTE: Safe from inside the listener's own callback, the dispatch in progress keeps its table
+    if (type.Waiters.empty() && type.InFlight.empty())
+    {
+        type.Listener.reset();
+    }
+}
@@ -0,0 +1,183 @@
+#include "general/pch.h"
+
+#include "EventInstrumentation.h"
+#include "Layer.h"
+
+namespace
+{
+
+template <typename Stats> void SortByTotalTime(std::vector<Stats> &stats)
+{
+    std::ranges::sort(stats, [](const Stats &a, const Stats &b) { return a.TotalNs > b.TotalNs; });
+}
+
+} // namespace
+
+void ae::TimestampCalibration::Start() noexcept
+{
+    m_StartTicks = EventInstrumentation::ReadTimestamp();
+    m_StartTime = std::chrono::steady_clock::now();
+}
+
+double ae::TimestampCalibration::GetNanosecondsPerTick() const noexcept
+{
+#ifdef AE_HAS_TSC
+    const uint64_t elapsedTicks = EventInstrumentation::ReadTimestamp() - m_StartTicks;
+    const double elapsedNanoseconds =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_StartTime).count();
+
+    if (!IsStarted() || elapsedTicks == 0)
+    {
+        return 1.0;
+    }
+
+    return elapsedNanoseconds / static_cast<double>(elapsedTicks);
+#else
+    using Period = std::chrono::steady_clock::period;
+    return 1e9 * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+#endif
+}
+
+void ae::EventInstrumentation::SetEnabled(bool enabled) noexcept
+{
+    if (enabled && !m_Calibration.IsStarted())
+    {
+        m_Calibration.Start();
+    }
+
+    m_Enabled = enabled;
+}
+
+void ae::EventInstrumentation::Reset() noexcept
+{
+    std::ranges::fill(m_EventTypes, Counters());
+    m_Layers.clear();
+    m_LayerIndicesByName.clear();
+    m_LayerIndices.clear();
+
+    for (size_t page = 0; page < MAX_LISTENER_PAGES && m_pListenerPages[page] != nullptr; page++)
+    {
+        for (ListenerCounters &listener : m_pListenerPages[page]->Listeners)
+        {
+            listener.Total = Counters();
+        }
+    }
+
+    m_Calibration.Start();
+}
+
+ae::InstrumentationSnapshot ae::EventInstrumentation::GetSnapshot() const
+{
+    const double nanosecondsPerTick = m_Calibration.GetNanosecondsPerTick();
+    InstrumentationSnapshot snapshot;
+
+    for (uint32_t i = 0; i < m_EventTypes.size(); i++)
+    {
+        const Counters &counters = m_EventTypes[i];
+
+        if (counters.Count == 0)
+        {
+            continue;
+        }
+
+        snapshot.EventTypes.push_back(
+            EventTypeStats{ .TypeId = detail::GetEventTypeIdFromIndex(i),
+                            .DispatchCount = counters.Count,
+                            .ConsumedCount = counters.ConsumedCount,
+                            .TotalNs = static_cast<double>(counters.TotalTicks) * nanosecondsPerTick,
+                            .MaxNs = static_cast<double>(counters.MaxTicks) * nanosecondsPerTick });
+    }
+
+    for (size_t page = 0; page < MAX_LISTENER_PAGES && m_pListenerPages[page] != nullptr; page++)
+    {
+        for (const ListenerCounters &listener : m_pListenerPages[page]->Listeners)
+        {
+            if (listener.Total.Count == 0)
+            {
+                continue;
+            }
+
+            snapshot.Listeners.push_back(
+                ListenerStats{ .Handle = listener.Handle,
+                               .TypeId = listener.TypeId,
+                               .CallCount = listener.Total.Count,
+                               .ConsumedCount = listener.Total.ConsumedCount,
+                               .TotalNs = static_cast<double>(listener.Total.TotalTicks) * nanosecondsPerTick,
+                               .MaxNs = static_cast<double>(listener.Total.MaxTicks) * nanosecondsPerTick });
+        }
+    }
+
+    snapshot.Layers.reserve(m_Layers.size());
+
+    for (const LayerCounters &layer : m_Layers)
+    {
+        if (layer.Total.Count == 0)
+        {
+            continue;
+        }
+
+        snapshot.Layers.push_back(
+            LayerStats{ .Name = layer.Name,
+                        .EventCount = layer.Total.Count,
+                        .ConsumedCount = layer.Total.ConsumedCount,
+                        .TotalNs = static_cast<double>(layer.Total.TotalTicks) * nanosecondsPerTick,
+                        .MaxNs = static_cast<double>(layer.Total.MaxTicks) * nanosecondsPerTick });
+    }
+
+    SortByTotalTime(snapshot.EventTypes);
+    SortByTotalTime(snapshot.Listeners);
+    SortByTotalTime(snapshot.Layers);
+
+    return snapshot;
+}
+
+void ae::EventInstrumentation::RecordDispatch(uint32_t typeId, bool consumed, uint64_t ticks)
+{
+    const uint32_t typeIndex = detail::GetEventTypeIndex(typeId);
+
+    // NOTE: Ids of no known type can only reach catch-all listeners, which are still counted per listener
+    if (typeIndex == detail::INVALID_EVENT_TYPE_INDEX)
+    {
+        return;
+    }
+
+    if (typeIndex >= m_EventTypes.size())
+    {
+        m_EventTypes.resize(std::max(typeIndex + 1, GetEventTypeCount()));
+    }
+
+    m_EventTypes[typeIndex].Add(consumed, ticks);
+}
+
+uint32_t ae::EventInstrumentation::GetLayerIndex(const Layer *pLayer)
+{
+    auto [it, inserted] = m_LayerIndices.try_emplace(pLayer, 0);
+
+    if (inserted)
+    {
+        const auto index = static_cast<uint32_t>(m_Layers.size());
+        const auto [nameIt, nameInserted] = m_LayerIndicesByName.try_emplace(pLayer->GetName(), index);
+
+        if (nameInserted)
+        {
+            m_Layers.push_back(LayerCounters{ .Name = pLayer->GetName(), .Total = Counters() });
+        }
+
+        it->second = nameIt->second;
+    }
+
+    return it->second;
+}
+
+void ae::EventInstrumentation::OnListenerAdded(EventListenerHandle handle, uint32_t typeId)
+{
+    std::unique_ptr<ListenerPage> &pPage = m_pListenerPages[handle.Index / LISTENER_PAGE_SIZE];
+
+    if (pPage == nullptr)
+    {
+        pPage = std::make_unique<ListenerPage>();
+    }
+
+    pPage->Listeners[handle.Index % LISTENER_PAGE_SIZE] =
+        ListenerCounters{ .Handle = handle, .TypeId = typeId, .Total = Counters() };
+}
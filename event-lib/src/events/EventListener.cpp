@@ -1,32 +1,91 @@
 #include "general/pch.h"
 
-#include "../internal/events/EventManager.h"
 #include "Event.h"
+#include "EventManager.h"
 
-ae::EventListener::EventListener() : m_Callback(nullptr)
+ae::EventListener::EventListener()
+    : EventListener(EventManager::Get(), static_cast<uint32_t>(EventType::NONE), ~EventCategoryWrapper(), nullptr)
 {
-    EventManager::Get().AddListener(this);
 }
 
-ae::EventListener::EventListener(std::function<void(ae::Event &)> callback) : m_Callback(std::move(callback))
+ae::EventListener::EventListener(std::function<void(ae::Event &)> callback)
+    : EventListener(EventManager::Get(), std::move(callback))
 {
-    EventManager::Get().AddListener(this);
 }
 
-ae::EventListener::EventListener(ae::EventListener &&other) noexcept : m_Callback(std::move(other.m_Callback))
+ae::EventListener::EventListener(uint32_t typeId, std::function<void(ae::Event &)> callback)
+    : EventListener(EventManager::Get(), typeId, std::move(callback))
 {
-    EventManager::Get().RemoveListener(&other);
-    EventManager::Get().AddListener(this);
-    other.m_Callback = nullptr;
+}
+
+ae::EventListener::EventListener(ae::EventDelegate delegate) : EventListener(EventManager::Get(), delegate)
+{
+}
+
+ae::EventListener::EventListener(uint32_t typeId, ae::EventDelegate delegate)
+    : EventListener(EventManager::Get(), typeId, delegate)
+{
+}
+
+ae::EventListener::EventListener(ae::EventBus &bus, std::function<void(ae::Event &)> callback)
+    : EventListener(bus, static_cast<uint32_t>(EventType::NONE), ~EventCategoryWrapper(), std::move(callback))
+{
+}
+
+ae::EventListener::EventListener(ae::EventBus &bus, uint32_t typeId, std::function<void(ae::Event &)> callback)
+    : EventListener(bus, typeId, ~EventCategoryWrapper(), std::move(callback))
+{
+}
+
+ae::EventListener::EventListener(ae::EventBus &bus, ae::EventDelegate delegate)
+    : EventListener(bus, static_cast<uint32_t>(EventType::NONE), delegate)
+{
+}
+
+ae::EventListener::EventListener(ae::EventBus &bus, uint32_t typeId, ae::EventDelegate delegate)
+    : m_pBus(&bus), m_TypeId(typeId), m_CategoryMask(~EventCategoryWrapper())
+{
+    m_Handle = bus.AddListener(typeId, m_CategoryMask, delegate);
+}
+
+ae::EventListener::EventListener(ae::EventBus &bus, uint32_t typeId, ae::EventCategoryWrapper categories,
+                                 std::function<void(ae::Event &)> callback)
+    : m_pBus(&bus), m_TypeId(typeId), m_CategoryMask(categories)
+{
+    m_Handle = bus.AddListener(typeId, categories, std::move(callback));
+}
+
+ae::EventListener::EventListener(ae::EventBus &bus, uint32_t typeId, ae::detail::BatchCallback callback)
+    : m_pBus(&bus), m_TypeId(typeId), m_CategoryMask(~EventCategoryWrapper()), m_Batch(true)
+{
+    m_Handle = bus.AddBatchListener(typeId, std::move(callback));
+}
+
+ae::EventListener::EventListener(ae::EventListener &&other) noexcept
+    : m_pBus(other.m_pBus), m_Handle(other.m_Handle), m_TypeId(other.m_TypeId), m_Priority(other.m_Priority),
+      m_Throttle(other.m_Throttle), m_CategoryMask(other.m_CategoryMask), m_Batch(other.m_Batch)
+{
+    // NOTE: The callback lives in the EventBus, so moving only transfers the handle
+    other.m_Handle = EventListenerHandle();
 }
 
 ae::EventListener &ae::EventListener::operator=(ae::EventListener &&other) noexcept
 {
     if (this != &other)
     {
-        EventManager::Get().RemoveListener(&other);
-        m_Callback = std::move(other.m_Callback);
-        other.m_Callback = nullptr;
+        if (m_Handle.IsValid())
+        {
+            m_pBus->RemoveListener(m_Handle);
+        }
+
+        m_pBus = other.m_pBus;
+        m_Handle = other.m_Handle;
+        m_TypeId = other.m_TypeId;
+        m_Priority = other.m_Priority;
+        m_Throttle = other.m_Throttle;
+        m_CategoryMask = other.m_CategoryMask;
+        m_Batch = other.m_Batch;
+        other.m_Handle = EventListenerHandle();
     }
 
     return *this;
@@ -34,10 +93,119 @@ ae::EventListener &ae::EventListener::operator=(ae::EventListener &&other) noexc
 
 ae::EventListener::~EventListener()
 {
-    EventManager::Get().RemoveListener(this);
+    if (m_Handle.IsValid())
+    {
+        m_pBus->RemoveListener(m_Handle);
+    }
+}
+
+ae::EventListener ae::EventListener::ForCategories(ae::EventCategoryWrapper categories,
+                                                   std::function<void(ae::Event &)> callback)
+{
+    return ForCategories(EventManager::Get(), categories, std::move(callback));
+}
+
+ae::EventListener ae::EventListener::ForCategories(ae::EventBus &bus, ae::EventCategoryWrapper categories,
+                                                   std::function<void(ae::Event &)> callback)
+{
+    return EventListener(bus, static_cast<uint32_t>(EventType::NONE), categories, std::move(callback));
 }
 
 void ae::EventListener::SetCallback(std::function<void(Event &)> callback)
 {
-    m_Callback = std::move(callback);
+    if (m_Batch)
+    {
+        AE_LOG(AE_WARNING, "Tried to set a per-event callback on a batch EventListener");
+        return;
+    }
+
+    if (!m_Handle.IsValid())
+    {
+        AE_LOG(AE_WARNING, "Tried to set callback on EventListener that has been moved from");
+        return;
+    }
+
+    m_pBus->SetListenerCallback(m_Handle, std::move(callback));
+}
+
+void ae::EventListener::SetCallback(EventDelegate delegate)
+{
+    if (m_Batch)
+    {
+        AE_LOG(AE_WARNING, "Tried to set a per-event callback on a batch EventListener");
+        return;
+    }
+
+    if (!m_Handle.IsValid())
+    {
+        AE_LOG(AE_WARNING, "Tried to set callback on EventListener that has been moved from");
+        return;
+    }
+
+    m_pBus->SetListenerCallback(m_Handle, delegate);
+}
+
+void ae::EventListener::SetCategoryMask(EventCategoryWrapper categories)
+{
+    if (m_Batch)
+    {
+        AE_LOG(AE_WARNING, "Tried to set category mask of a batch EventListener, batches are only selected by type");
+        return;
+    }
+
+    if (m_CategoryMask == categories)
+    {
+        return;
+    }
+
+    m_CategoryMask = categories;
+
+    if (m_Handle.IsValid())
+    {
+        m_pBus->SetListenerCategoryMask(m_Handle, categories);
+    }
+}
+
+void ae::EventListener::SetPriority(int32_t priority)
+{
+    if (m_Priority == priority)
+    {
+        return;
+    }
+
+    m_Priority = priority;
+
+    if (m_Handle.IsValid())
+    {
+        m_pBus->SetListenerPriority(m_Handle, priority);
+    }
+}
+
+void ae::EventListener::SetThrottle(const EventThrottle &throttle)
+{
+    if (m_Batch)
+    {
+        AE_LOG(AE_WARNING, "Tried to throttle a batch EventListener, batches are delivered whole");
+        return;
+    }
+
+    if (throttle.pTrailing != nullptr && throttle.pTrailing->pGetTypeId() != m_TypeId)
+    {
+        AE_LOG(AE_WARNING, "Tried to set a trailing throttle for another event type than the EventListener receives");
+        return;
+    }
+
+    if (!m_Handle.IsValid())
+    {
+        AE_LOG(AE_WARNING, "Tried to set throttle on EventListener that has been moved from");
+        return;
+    }
+
+    m_Throttle = throttle;
+    m_pBus->SetListenerThrottle(m_Handle, throttle);
+}
+
+ae::EventBus &ae::EventListener::GetGlobalBus() noexcept
+{
+    return EventManager::Get();
 }
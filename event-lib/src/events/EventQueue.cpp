@@ -0,0 +1,155 @@
+#include "general/pch.h"
+
+#include "EventQueue.h"
+
+ae::EventQueue::EventQueue(size_t capacity) : m_InitialCapacity(GetRecordSize(capacity)) {}
+
+ae::EventQueue::~EventQueue()
+{
+    DestroyRecords(m_Buffers[0]);
+    DestroyRecords(m_Buffers[1]);
+}
+
+void ae::EventQueue::Flush(EventDelegate dispatch)
+{
+    if (m_Flushing)
+    {
+        AE_LOG(AE_WARNING, "Tried to flush EventQueue from inside a flush, the nested flush is ignored");
+        return;
+    }
+
+    m_Flushing = true;
+
+    // NOTE: New events go to the other buffer while this one is dispatched
+    Buffer &buffer = m_Buffers[m_WriteIndex];
+    m_WriteIndex ^= 1;
+
+    for (size_t offset = 0; offset < buffer.Size;)
+    {
+        auto *pHeader = reinterpret_cast<RecordHeader *>(buffer.pData.get() + offset);
+        void *pPayload = buffer.pData.get() + offset + RECORD_ALIGNMENT;
+
+        Event &event = pHeader->pOps->pGetEvent(pPayload);
+
+        if (pHeader->Nested)
+        {
+            const detail::DispatchScope dispatchScope;
+            dispatch(event);
+        }
+        else
+        {
+            dispatch(event);
+        }
+
+        if (pHeader->pOps->pDestroy != nullptr)
+        {
+            pHeader->pOps->pDestroy(pPayload);
+        }
+
+        offset += pHeader->Size;
+    }
+
+    buffer.Size = 0;
+    buffer.Count = 0;
+    buffer.CoalesceCount = 0;
+    m_Flushing = false;
+}
+
+void ae::EventQueue::Clear() noexcept
+{
+    DestroyRecords(m_Buffers[m_WriteIndex]);
+}
+
+void *ae::EventQueue::Allocate(size_t recordSize, const RecordOps *pOps)
+{
+    Buffer &buffer = m_Buffers[m_WriteIndex];
+
+    if (buffer.Size + recordSize > buffer.Capacity)
+    {
+        Grow(buffer, std::max(buffer.Size + recordSize, m_InitialCapacity));
+    }
+
+    auto *pHeader = new (buffer.pData.get() + buffer.Size)
+        RecordHeader{ pOps, static_cast<uint32_t>(recordSize), detail::GetDispatchDepth() > 0 };
+    void *pPayload = reinterpret_cast<std::byte *>(pHeader) + RECORD_ALIGNMENT;
+
+    buffer.Size += recordSize;
+    buffer.Count++;
+
+    return pPayload;
+}
+
+void *ae::EventQueue::FindCoalesceTarget(uint32_t typeId) noexcept
+{
+    Buffer &buffer = m_Buffers[m_WriteIndex];
+
+    for (uint32_t i = 0; i < buffer.CoalesceCount; i++)
+    {
+        if (buffer.CoalesceTargets[i].TypeId == typeId)
+        {
+            return buffer.pData.get() + buffer.CoalesceTargets[i].Offset;
+        }
+    }
+
+    return nullptr;
+}
+
+void ae::EventQueue::AddCoalesceTarget(uint32_t typeId, void *pPayload) noexcept
+{
+    Buffer &buffer = m_Buffers[m_WriteIndex];
+
+    // NOTE: Only a handful of types coalesce, once the table is full further types are simply queued
+    if (buffer.CoalesceCount == MAX_COALESCE_TARGETS)
+    {
+        return;
+    }
+
+    const auto offset = static_cast<uint32_t>(static_cast<std::byte *>(pPayload) - buffer.pData.get());
+    buffer.CoalesceTargets[buffer.CoalesceCount++] = CoalesceTarget{ .TypeId = typeId, .Offset = offset };
+}
+
+void ae::EventQueue::Grow(Buffer &buffer, size_t requiredSize)
+{
+    size_t capacity = std::max<size_t>(buffer.Capacity * 2, RECORD_ALIGNMENT);
+
+    while (capacity < requiredSize)
+    {
+        capacity *= 2;
+    }
+
+    auto pData = std::make_unique_for_overwrite<std::byte[]>(capacity);
+
+    // NOTE: Records are relocated one by one since payloads may not be trivially copyable
+    for (size_t offset = 0; offset < buffer.Size;)
+    {
+        auto *pHeader = reinterpret_cast<RecordHeader *>(buffer.pData.get() + offset);
+        new (pData.get() + offset) RecordHeader(*pHeader);
+        pHeader->pOps->pRelocate(pData.get() + offset + RECORD_ALIGNMENT,
+                                 buffer.pData.get() + offset + RECORD_ALIGNMENT);
+        offset += pHeader->Size;
+    }
+
+    AE_LOG(AE_TRACE, "Grew EventQueue buffer from {} to {} bytes", buffer.Capacity, capacity);
+
+    buffer.pData = std::move(pData);
+    buffer.Capacity = capacity;
+}
+
+void ae::EventQueue::DestroyRecords(Buffer &buffer) noexcept
+{
+    for (size_t offset = 0; offset < buffer.Size;)
+    {
+        auto *pHeader = reinterpret_cast<RecordHeader *>(buffer.pData.get() + offset);
+
+        if (pHeader->pOps->pDestroy != nullptr)
+        {
+            pHeader->pOps->pDestroy(buffer.pData.get() + offset + RECORD_ALIGNMENT);
+        }
+
+        offset += pHeader->Size;
+    }
+
+    buffer.Size = 0;
+    buffer.Count = 0;
+    buffer.CoalesceCount = 0;
+}
@@ -0,0 +1,427 @@
+#include "general/pch.h"
+
+#include "EventBus.h"
+#include "EventRecording.h"
+
+#include <limits>
+
+namespace
+{
+
+// NOTE: File layout, all values in host byte order:
+//     Header:  uint32_t Magic, uint32_t Version
+//     Record:  uint16_t TypeIndex, uint32_t PayloadSize, uint64_t TimestampNs, payload
+// Type index 0 marks a type definition whose payload is the uint16_t index it introduces followed by the type name.
+// A type is defined right before its first event, so recordings can be written and read as a stream
+constexpr uint32_t RECORDING_MAGIC = 0x52564541; // NOTE: "AEVR"
+constexpr uint32_t RECORDING_VERSION = 1;
+constexpr size_t HEADER_SIZE = sizeof(uint32_t) * 2;
+constexpr size_t RECORD_HEADER_SIZE = sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint64_t);
+constexpr uint16_t TYPE_DEFINITION = 0;
+
+template <typename T> T ReadValue(std::span<const std::byte> data, size_t offset) noexcept
+{
+    T value{};
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+template <typename... Ts> void AddBuiltinTypes(std::vector<ae::detail::RecordableEventType> &types)
+{
+    ((types[ae::detail::GetEventTypeIndex(ae::EventTypeId<Ts>::Get())] =
+          ae::detail::RecordableEventType{ .Name = ae::EventSerialization<Ts>::Name,
+                                           .pWrite = &ae::detail::WriteRecordedEvent<Ts>,
+                                           .pReplay = &ae::detail::ReplayRecordedEvent<Ts> }),
+     ...);
+}
+
+// NOTE: Indexed by detail::GetEventTypeIndex(). Entries without a name are not recordable
+std::vector<ae::detail::RecordableEventType> &GetRecordableTypes()
+{
+    static std::vector<ae::detail::RecordableEventType> s_Types = []
+    {
+        std::vector<ae::detail::RecordableEventType> types(ae::detail::BUILTIN_EVENT_COUNT);
+        AddBuiltinTypes<ae::KeyPressedEvent, ae::KeyReleasedEvent, ae::KeyTypedEvent, ae::MouseButtonPressedEvent,
+                        ae::MouseButtonReleasedEvent, ae::MouseMovedEvent, ae::MouseScrolledEvent,
+                        ae::MouseEnteredEvent, ae::MouseExitedEvent, ae::WindowResizeEvent, ae::WindowMinimizedEvent,
+                        ae::WindowMaximizedEvent, ae::WindowRestoredEvent, ae::WindowMovedEvent,
+                        ae::WindowFocusedEvent, ae::WindowCloseEvent, ae::FramebufferResizeEvent,
+                        ae::ContentScaleChangedEvent, ae::FileDropEvent, ae::ControllerConnectedEvent,
+                        ae::ControllerDisconnectedEvent, ae::UpdateEvent, ae::RenderEvent>(types);
+        return types;
+    }();
+
+    return s_Types;
+}
+
+const ae::detail::RecordableEventType *FindRecordableType(uint32_t typeId)
+{
+    const std::vector<ae::detail::RecordableEventType> &types = GetRecordableTypes();
+    const uint32_t typeIndex = ae::detail::GetEventTypeIndex(typeId);
+
+    if (typeIndex >= types.size() || types[typeIndex].pWrite == nullptr)
+    {
+        return nullptr;
+    }
+
+    return &types[typeIndex];
+}
+
+const ae::detail::RecordableEventType *FindRecordableType(std::string_view name)
+{
+    for (const ae::detail::RecordableEventType &type : GetRecordableTypes())
+    {
+        if (type.pWrite != nullptr && type.Name == name)
+        {
+            return &type;
+        }
+    }
+
+    return nullptr;
+}
+
+uint32_t FindRecordableTypeIndex(std::string_view name)
+{
+    const ae::detail::RecordableEventType *pType = FindRecordableType(name);
+    return pType != nullptr ? static_cast<uint32_t>(pType - GetRecordableTypes().data())
+                            : ae::detail::INVALID_EVENT_TYPE_INDEX;
+}
+
+} // namespace
+
+void ae::detail::RegisterRecordableEventType(uint32_t typeId, const RecordableEventType &type)
+{
+    std::vector<RecordableEventType> &types = GetRecordableTypes();
+    const uint32_t typeIndex = GetEventTypeIndex(typeId);
+
+    if (typeIndex == INVALID_EVENT_TYPE_INDEX)
+    {
+        AE_LOG(AE_WARNING, "Tried to register recordable event '{}' without a valid type id", type.Name);
+        return;
+    }
+
+    const RecordableEventType *pExisting = FindRecordableType(type.Name);
+
+    if (pExisting != nullptr && static_cast<uint32_t>(pExisting - types.data()) != typeIndex)
+    {
+        AE_LOG(AE_WARNING, "Tried to register recordable event '{}' twice under different types", type.Name);
+        return;
+    }
+
+    if (typeIndex >= types.size())
+    {
+        types.resize(typeIndex + 1);
+    }
+
+    types[typeIndex] = type;
+}
+
+const ae::detail::RecordableEventType *ae::detail::FindRecordableEventType(uint32_t typeId)
+{
+    return FindRecordableType(typeId);
+}
+
+uint32_t ae::detail::FindRecordableEventTypeIndex(std::string_view name)
+{
+    return FindRecordableTypeIndex(name);
+}
+
+const ae::detail::RecordableEventType &ae::detail::GetRecordableEventType(uint32_t typeIndex)
+{
+    return GetRecordableTypes()[typeIndex];
+}
+
+ae::EventRecorder::~EventRecorder()
+{
+    Stop();
+}
+
+bool ae::EventRecorder::Start(const std::string &path)
+{
+    Stop();
+
+    m_File.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!m_File)
+    {
+        AE_LOG(AE_WARNING, "Failed to open '{}' for recording events", path);
+        return false;
+    }
+
+    m_Buffer.clear();
+    m_Buffer.reserve(WRITE_BUFFER_SIZE);
+    m_TypeIndices.assign(GetEventTypeCount(), 0);
+    m_SkippedTypes.assign(GetEventTypeCount(), false);
+    m_NextTypeIndex = 1;
+    m_RecordedEventCount = 0;
+
+    EventWriter writer(m_Buffer);
+    writer.Write(RECORDING_MAGIC);
+    writer.Write(RECORDING_VERSION);
+
+    m_Listener.emplace(EventDelegate::Bind<&EventRecorder::OnEvent>(this));
+    m_Listener->SetPriority(EventBus::OBSERVER_PRIORITY);
+    m_StartTime = std::chrono::steady_clock::now();
+
+    AE_LOG(AE_TRACE, "Started recording events to '{}'", path);
+    return true;
+}
+
+void ae::EventRecorder::Stop()
+{
+    if (!m_File.is_open())
+    {
+        return;
+    }
+
+    m_Listener.reset();
+    FlushBuffer();
+    m_File.close();
+
+    if (m_File.fail())
+    {
+        AE_LOG(AE_WARNING, "Failed to write the event recording");
+    }
+
+    AE_LOG(AE_TRACE, "Stopped recording after {} events", m_RecordedEventCount);
+}
+
+void ae::EventRecorder::OnEvent(Event &event)
+{
+    // NOTE: Only events no other event caused. Replaying their causes dispatches them again, like timers fired by an
+    // UpdateEvent or events a listener dispatches
+    if (detail::GetDispatchDepth() > 1)
+    {
+        return;
+    }
+
+    const uint64_t timestampNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_StartTime).count());
+    const uint32_t typeIndex = detail::GetEventTypeIndex(event.GetTypeId());
+
+    // NOTE: Ids of no known type could not be matched to a type on replay
+    if (typeIndex == detail::INVALID_EVENT_TYPE_INDEX)
+    {
+        return;
+    }
+
+    const detail::RecordableEventType *pType = FindRecordableType(event.GetTypeId());
+
+    if (pType == nullptr)
+    {
+        if (typeIndex >= m_SkippedTypes.size())
+        {
+            m_SkippedTypes.resize(typeIndex + 1, false);
+        }
+
+        std::vector<bool>::reference warned = m_SkippedTypes[typeIndex];
+
+        if (!warned)
+        {
+            AE_LOG(AE_WARNING, "Event type {} has no EventSerialization and is not recorded", event.GetTypeId());
+            warned = true;
+        }
+
+        return;
+    }
+
+    if (typeIndex >= m_TypeIndices.size())
+    {
+        m_TypeIndices.resize(typeIndex + 1, 0);
+    }
+
+    uint16_t &recordedIndex = m_TypeIndices[typeIndex];
+
+    if (recordedIndex == 0)
+    {
+        recordedIndex = m_NextTypeIndex++;
+
+        const size_t recordOffset = m_Buffer.size();
+        WriteRecordHeader(TYPE_DEFINITION, timestampNs);
+
+        EventWriter writer(m_Buffer);
+        writer.Write(recordedIndex);
+        writer.WriteString(pType->Name);
+        FinishRecord(recordOffset);
+    }
+
+    const size_t recordOffset = m_Buffer.size();
+    WriteRecordHeader(recordedIndex, timestampNs);
+
+    EventWriter writer(m_Buffer);
+    pType->pWrite(event, writer);
+    FinishRecord(recordOffset);
+
+    m_RecordedEventCount++;
+
+    if (m_Buffer.size() >= WRITE_BUFFER_SIZE)
+    {
+        FlushBuffer();
+    }
+}
+
+void ae::EventRecorder::WriteRecordHeader(uint16_t typeIndex, uint64_t timestampNs)
+{
+    EventWriter writer(m_Buffer);
+    writer.Write(typeIndex);
+    writer.Write(uint32_t(0)); // NOTE: Payload size, patched by FinishRecord()
+    writer.Write(timestampNs);
+}
+
+void ae::EventRecorder::FinishRecord(size_t recordOffset)
+{
+    const auto payloadSize = static_cast<uint32_t>(m_Buffer.size() - recordOffset - RECORD_HEADER_SIZE);
+    std::memcpy(m_Buffer.data() + recordOffset + sizeof(uint16_t), &payloadSize, sizeof(payloadSize));
+}
+
+void ae::EventRecorder::FlushBuffer()
+{
+    m_File.write(reinterpret_cast<const char *>(m_Buffer.data()), static_cast<std::streamsize>(m_Buffer.size()));
+    m_Buffer.clear();
+}
+
+bool ae::EventReplay::Open(const std::string &path)
+{
+    Close();
+
+    if (!m_File.Open(path))
+    {
+        return false;
+    }
+
+    const std::span<const std::byte> data = m_File.GetData();
+
+    if (data.size() < HEADER_SIZE || ReadValue<uint32_t>(data, 0) != RECORDING_MAGIC)
+    {
+        AE_LOG(AE_WARNING, "'{}' is not an event recording", path);
+        Close();
+        return false;
+    }
+
+    const auto version = ReadValue<uint32_t>(data, sizeof(uint32_t));
+
+    if (version != RECORDING_VERSION)
+    {
+        AE_LOG(AE_WARNING, "Event recording '{}' has version {}, expected {}", path, version, RECORDING_VERSION);
+        Close();
+        return false;
+    }
+
+    m_FirstRecordOffset = HEADER_SIZE;
+    Rewind();
+    return true;
+}
+
+void ae::EventReplay::Close() noexcept
+{
+    m_File.Close();
+    m_Offset = 0;
+    m_FirstRecordOffset = 0;
+    m_Types.clear();
+    m_Started = false;
+}
+
+void ae::EventReplay::Rewind() noexcept
+{
+    m_Offset = m_FirstRecordOffset;
+    m_Started = false;
+}
+
+size_t ae::EventReplay::ReplayAll(EventDelegate target)
+{
+    return ReplayUntil(std::numeric_limits<uint64_t>::max(), target);
+}
+
+size_t ae::EventReplay::ReplayRealTime(EventDelegate target)
+{
+    if (!m_Started)
+    {
+        m_StartTime = std::chrono::steady_clock::now();
+        m_Started = true;
+    }
+
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_StartTime);
+    return ReplayUntil(static_cast<uint64_t>(elapsed.count()), target);
+}
+
+size_t ae::EventReplay::ReplayUntil(uint64_t timestampNs, EventDelegate target)
+{
+    const std::span<const std::byte> data = m_File.GetData();
+    size_t replayedCount = 0;
+
+    while (m_Offset < data.size())
+    {
+        if (data.size() - m_Offset < RECORD_HEADER_SIZE)
+        {
+            AE_LOG(AE_WARNING, "Event recording ends in a truncated record");
+            m_Offset = data.size();
+            break;
+        }
+
+        const auto typeIndex = ReadValue<uint16_t>(data, m_Offset);
+        const auto payloadSize = ReadValue<uint32_t>(data, m_Offset + sizeof(uint16_t));
+        const auto recordTimestamp = ReadValue<uint64_t>(data, m_Offset + sizeof(uint16_t) + sizeof(uint32_t));
+
+        if (payloadSize > data.size() - m_Offset - RECORD_HEADER_SIZE)
+        {
+            AE_LOG(AE_WARNING, "Event recording ends in a truncated record");
+            m_Offset = data.size();
+            break;
+        }
+
+        if (recordTimestamp > timestampNs)
+        {
+            break;
+        }
+
+        EventReader reader(data.subspan(m_Offset + RECORD_HEADER_SIZE, payloadSize), m_Strings);
+        m_Offset += RECORD_HEADER_SIZE + payloadSize;
+
+        if (typeIndex == TYPE_DEFINITION)
+        {
+            const auto definedIndex = reader.Read<uint16_t>();
+            const std::string_view name = reader.ReadString();
+
+            if (reader.HasFailed() || definedIndex == TYPE_DEFINITION)
+            {
+                AE_LOG(AE_WARNING, "Skipped a corrupt type definition in the event recording");
+                continue;
+            }
+
+            if (definedIndex >= m_Types.size())
+            {
+                m_Types.resize(definedIndex + 1);
+            }
+
+            m_Types[definedIndex].TypeIndex = FindRecordableTypeIndex(name);
+
+            if (m_Types[definedIndex].TypeIndex == detail::INVALID_EVENT_TYPE_INDEX)
+            {
+                AE_LOG(AE_WARNING, "Recorded event type '{}' is not registered, its events are skipped", name);
+            }
+
+            continue;
+        }
+
+        if (typeIndex >= m_Types.size() || m_Types[typeIndex].TypeIndex == detail::INVALID_EVENT_TYPE_INDEX)
+        {
+            continue;
+        }
+
+        RecordedType &type = m_Types[typeIndex];
+        const detail::RecordableEventType &recordableType = GetRecordableTypes()[type.TypeIndex];
+
+        if (recordableType.pReplay(reader, target))
+        {
+            replayedCount++;
+        }
+        else if (!type.Warned)
+        {
+            AE_LOG(AE_WARNING, "Skipped a corrupt '{}' event in the event recording", recordableType.Name);
+            type.Warned = true;
+        }
+    }
+
+    return replayedCount;
+}
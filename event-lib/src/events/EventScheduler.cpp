@@ -0,0 +1,241 @@
+#include "general/pch.h"
+
+#include "EventScheduler.h"
+
+ae::EventScheduler::EventScheduler(EventDelegate dispatch, EventQueue &queue,
+                                   std::chrono::nanoseconds resolution) noexcept
+    : m_Dispatch(dispatch), m_Queue(queue), m_Resolution(std::max(resolution, std::chrono::nanoseconds(1)))
+{
+    m_SlotHeads.fill(INVALID_NODE);
+}
+
+ae::EventScheduler::~EventScheduler()
+{
+    Clear();
+}
+
+bool ae::EventScheduler::Cancel(TimerHandle handle) noexcept
+{
+    if (!IsPending(handle))
+    {
+        return false;
+    }
+
+    TimerNode &node = GetNode(handle.Index);
+    Unlink(handle.Index);
+
+    node.Storage.Reset();
+
+    FreeNode(handle.Index);
+    return true;
+}
+
+bool ae::EventScheduler::IsPending(TimerHandle handle) const noexcept
+{
+    if (handle.Index >= m_NodeCount)
+    {
+        return false;
+    }
+
+    const TimerNode &node = GetNode(handle.Index);
+    return node.pFire != nullptr && node.Generation == handle.Generation;
+}
+
+void ae::EventScheduler::Advance(std::chrono::nanoseconds time)
+{
+    m_PendingTime += std::max(time, std::chrono::nanoseconds(0));
+
+    const auto ticks = static_cast<uint64_t>(m_PendingTime / m_Resolution);
+    m_PendingTime %= m_Resolution;
+
+    for (uint64_t i = 0; i < ticks; i++)
+    {
+        // NOTE: An empty wheel has nothing to cascade, so the remaining time is skipped at once
+        if (m_PendingCount == 0)
+        {
+            m_CurrentTick += ticks - i;
+            return;
+        }
+
+        Tick();
+    }
+}
+
+void ae::EventScheduler::Clear() noexcept
+{
+    for (uint32_t slot = 0; slot < SLOT_COUNT; slot++)
+    {
+        while (m_SlotHeads[slot] != INVALID_NODE)
+        {
+            const uint32_t nodeIndex = m_SlotHeads[slot];
+            TimerNode &node = GetNode(nodeIndex);
+            Unlink(nodeIndex);
+
+            node.Storage.Reset();
+
+            FreeNode(nodeIndex);
+        }
+    }
+}
+
+uint64_t ae::EventScheduler::ToTicks(std::chrono::nanoseconds time) const noexcept
+{
+    if (time <= m_Resolution)
+    {
+        return 1;
+    }
+
+    return static_cast<uint64_t>((time + m_Resolution - std::chrono::nanoseconds(1)) / m_Resolution);
+}
+
+uint32_t ae::EventScheduler::AllocateNode()
+{
+    if (m_FreeNodes != INVALID_NODE)
+    {
+        const uint32_t nodeIndex = m_FreeNodes;
+        m_FreeNodes = GetNode(nodeIndex).Next;
+        return nodeIndex;
+    }
+
+    if (m_NodeCount % NODE_PAGE_SIZE == 0)
+    {
+        m_pNodePages.push_back(std::make_unique<NodePage>());
+    }
+
+    return m_NodeCount++;
+}
+
+void ae::EventScheduler::FreeNode(uint32_t nodeIndex) noexcept
+{
+    // NOTE: Invalidates every handle to the timer
+    TimerNode &node = GetNode(nodeIndex);
+    node.pFire = nullptr;
+    node.Generation++;
+    node.Next = m_FreeNodes;
+    m_FreeNodes = nodeIndex;
+    m_PendingCount--;
+}
+
+void ae::EventScheduler::Link(uint32_t nodeIndex) noexcept
+{
+    TimerNode &node = GetNode(nodeIndex);
+
+    // NOTE: Already expired timers, such as those cascaded from a higher level, go into the slot of this tick
+    const uint64_t expires = std::max(node.Expires, m_CurrentTick);
+    const uint64_t delta = std::min(expires - m_CurrentTick, MAX_TICKS - 1);
+    const uint64_t placed = m_CurrentTick + delta;
+
+    uint32_t slot = 0;
+
+    if (delta < LOW_LEVEL_SLOTS)
+    {
+        slot = static_cast<uint32_t>(placed % LOW_LEVEL_SLOTS);
+    }
+    else
+    {
+        uint32_t level = 0;
+        uint32_t shift = LOW_LEVEL_BITS + HIGH_LEVEL_BITS;
+
+        while (level + 1 < HIGH_LEVEL_COUNT && delta >= uint64_t(1) << shift)
+        {
+            level++;
+            shift += HIGH_LEVEL_BITS;
+        }
+
+        const uint64_t index = (placed >> (shift - HIGH_LEVEL_BITS)) % HIGH_LEVEL_SLOTS;
+        slot = LOW_LEVEL_SLOTS + level * HIGH_LEVEL_SLOTS + static_cast<uint32_t>(index);
+    }
+
+    node.Slot = slot;
+    node.Prev = INVALID_NODE;
+    node.Next = m_SlotHeads[slot];
+
+    if (node.Next != INVALID_NODE)
+    {
+        GetNode(node.Next).Prev = nodeIndex;
+    }
+
+    m_SlotHeads[slot] = nodeIndex;
+}
+
+void ae::EventScheduler::Unlink(uint32_t nodeIndex) noexcept
+{
+    TimerNode &node = GetNode(nodeIndex);
+
+    if (node.Prev != INVALID_NODE)
+    {
+        GetNode(node.Prev).Next = node.Next;
+    }
+    else
+    {
+        m_SlotHeads[node.Slot] = node.Next;
+    }
+
+    if (node.Next != INVALID_NODE)
+    {
+        GetNode(node.Next).Prev = node.Prev;
+    }
+
+    node.Prev = INVALID_NODE;
+    node.Next = INVALID_NODE;
+}
+
+void ae::EventScheduler::Tick()
+{
+    m_CurrentTick++;
+
+    // NOTE: When the low level wraps, the next slot of each higher level that also wrapped is spread out below it
+    if (m_CurrentTick % LOW_LEVEL_SLOTS == 0)
+    {
+        uint32_t shift = LOW_LEVEL_BITS;
+
+        for (uint32_t level = 0; level < HIGH_LEVEL_COUNT; level++)
+        {
+            Cascade(level);
+            shift += HIGH_LEVEL_BITS;
+
+            if ((m_CurrentTick & ((uint64_t(1) << shift) - 1)) != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    // NOTE: Listeners may schedule or cancel timers while one fires. New timers never land in this slot, so it is
+    // emptied one node at a time
+    const uint32_t slot = static_cast<uint32_t>(m_CurrentTick % LOW_LEVEL_SLOTS);
+
+    while (m_SlotHeads[slot] != INVALID_NODE)
+    {
+        const uint32_t nodeIndex = m_SlotHeads[slot];
+        TimerNode &node = GetNode(nodeIndex);
+        Unlink(nodeIndex);
+
+        const bool periodic = node.Interval != 0;
+
+        if (periodic)
+        {
+            node.Expires = m_CurrentTick + node.Interval;
+            Link(nodeIndex);
+        }
+
+        node.pFire(*this, nodeIndex, periodic);
+    }
+}
+
+void ae::EventScheduler::Cascade(uint32_t level)
+{
+    const uint32_t shift = LOW_LEVEL_BITS + level * HIGH_LEVEL_BITS;
+    const auto index = static_cast<uint32_t>((m_CurrentTick >> shift) % HIGH_LEVEL_SLOTS);
+    const uint32_t slot = LOW_LEVEL_SLOTS + level * HIGH_LEVEL_SLOTS + index;
+
+    uint32_t nodeIndex = m_SlotHeads[slot];
+    m_SlotHeads[slot] = INVALID_NODE;
+
+    while (nodeIndex != INVALID_NODE)
+    {
+        const uint32_t nextIndex = GetNode(nodeIndex).Next;
+        Link(nodeIndex);
+        nodeIndex = nextIndex;
+    }
+}
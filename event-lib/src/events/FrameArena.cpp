@@ -0,0 +1,117 @@
+#include "general/pch.h"
+
+#include "FrameArena.h"
+
+#include <cstring>
+#include <numeric>
+
+ae::FrameArena::FrameArena(size_t blockSize) : m_BlockSize(blockSize) {}
+
+void *ae::FrameArena::Allocate(size_t size, size_t alignment)
+{
+    if (!m_Blocks.empty())
+    {
+        Block &block = m_Blocks.back();
+        const auto base = reinterpret_cast<uintptr_t>(block.pData.get());
+        const uintptr_t aligned = (base + m_Offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        const size_t offset = static_cast<size_t>(aligned - base);
+
+        if (offset + size <= block.Size)
+        {
+            m_Offset = offset + size;
+            m_UsedBytes += size;
+            return block.pData.get() + offset;
+        }
+    }
+
+    AddBlock(size + alignment);
+    return Allocate(size, alignment);
+}
+
+std::span<std::byte> ae::FrameArena::CopyBytes(std::span<const std::byte> bytes)
+{
+    auto *pData = static_cast<std::byte *>(Allocate(bytes.size(), 1));
+    std::memcpy(pData, bytes.data(), bytes.size());
+    return std::span<std::byte>(pData, bytes.size());
+}
+
+std::string_view ae::FrameArena::CopyString(std::string_view string)
+{
+    auto *pData = static_cast<char *>(Allocate(string.size(), 1));
+    std::memcpy(pData, string.data(), string.size());
+    return std::string_view(pData, string.size());
+}
+
+std::span<const std::string_view> ae::FrameArena::CopyStrings(std::span<const std::string_view> strings)
+{
+    const size_t characterCount =
+        std::accumulate(strings.begin(), strings.end(), size_t(0),
+                        [](size_t sum, std::string_view string) { return sum + string.size(); });
+
+    auto *pViews = static_cast<std::string_view *>(
+        Allocate(sizeof(std::string_view) * strings.size() + characterCount, alignof(std::string_view)));
+    auto *pCharacters = reinterpret_cast<char *>(pViews + strings.size());
+
+    for (size_t i = 0; i < strings.size(); i++)
+    {
+        std::memcpy(pCharacters, strings[i].data(), strings[i].size());
+        new (pViews + i) std::string_view(pCharacters, strings[i].size());
+        pCharacters += strings[i].size();
+    }
+
+    return std::span<const std::string_view>(pViews, strings.size());
+}
+
+std::span<const std::string_view> ae::FrameArena::CopyStrings(const char *const *ppStrings, size_t count)
+{
+    size_t characterCount = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        characterCount += std::strlen(ppStrings[i]);
+    }
+
+    auto *pViews = static_cast<std::string_view *>(
+        Allocate(sizeof(std::string_view) * count + characterCount, alignof(std::string_view)));
+    auto *pCharacters = reinterpret_cast<char *>(pViews + count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const size_t length = std::strlen(ppStrings[i]);
+        std::memcpy(pCharacters, ppStrings[i], length);
+        new (pViews + i) std::string_view(pCharacters, length);
+        pCharacters += length;
+    }
+
+    return std::span<const std::string_view>(pViews, count);
+}
+
+void ae::FrameArena::Reset()
+{
+    // NOTE: Replace several blocks with one that fits the whole frame, so the next frame is a single bump region
+    if (m_Blocks.size() > 1)
+    {
+        const size_t capacity = GetCapacity();
+        m_Blocks.clear();
+        AddBlock(capacity);
+
+        AE_LOG(AE_TRACE, "Merged FrameArena blocks into one block of {} bytes", capacity);
+    }
+
+    m_Offset = 0;
+    m_UsedBytes = 0;
+}
+
+size_t ae::FrameArena::GetCapacity() const noexcept
+{
+    return std::accumulate(m_Blocks.begin(), m_Blocks.end(), size_t(0),
+                           [](size_t sum, const Block &block) { return sum + block.Size; });
+}
+
+void ae::FrameArena::AddBlock(size_t minimumSize)
+{
+    const size_t size = std::max(m_BlockSize, minimumSize);
+
+    m_Blocks.push_back(Block{ .pData = std::make_unique_for_overwrite<std::byte[]>(size), .Size = size });
+    m_Offset = 0;
+}
@@ -0,0 +1,232 @@
+#include "general/pch.h"
+
+#include "EventManager.h"
+#include "InputState.h"
+
+#include <cstring>
+
+ae::InputState::InputState() : InputState(EventManager::Get()) {}
+
+ae::InputState::InputState(EventBus &bus) : m_Listener(bus, EventDelegate::Bind<&InputState::OnEvent>(this))
+{
+    m_Listener.SetCategoryMask(EventCategory::INPUT | EventCategory::WINDOW);
+
+    // NOTE: Ahead of user listeners, so layers that consume input still leave the state accurate
+    m_Listener.SetPriority(EventBus::INPUT_STATE_PRIORITY);
+
+    Publish();
+}
+
+void ae::InputState::Publish() noexcept
+{
+    std::array<uint64_t, SNAPSHOT_WORDS> words{};
+    std::memcpy(words.data(), static_cast<const void *>(&m_Current), sizeof(InputSnapshot));
+
+    // NOTE: Writes the slot readers are not directed to, then points them at it
+    const uint32_t slotIndex = m_PublishedSlot.load(std::memory_order_relaxed) ^ 1;
+    SnapshotSlot &slot = m_Slots[slotIndex];
+    const uint32_t sequence = slot.Sequence.load(std::memory_order_relaxed);
+
+    slot.Sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < SNAPSHOT_WORDS; i++)
+    {
+        slot.Words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    slot.Sequence.store(sequence + 2, std::memory_order_release);
+    m_PublishedSlot.store(slotIndex, std::memory_order_release);
+
+    m_Current.KeysPressed.fill(0);
+    m_Current.KeysReleased.fill(0);
+    m_Current.ButtonsPressed = 0;
+    m_Current.ButtonsReleased = 0;
+    m_Current.MouseDeltaX = 0.0f;
+    m_Current.MouseDeltaY = 0.0f;
+    m_Current.ScrollX = 0.0f;
+    m_Current.ScrollY = 0.0f;
+    m_Current.Frame++;
+}
+
+ae::InputSnapshot ae::InputState::GetSnapshot() const noexcept
+{
+    std::array<uint64_t, SNAPSHOT_WORDS> words{};
+
+    while (true)
+    {
+        const SnapshotSlot &slot = m_Slots[m_PublishedSlot.load(std::memory_order_acquire)];
+        const uint32_t sequence = slot.Sequence.load(std::memory_order_acquire);
+
+        if ((sequence & 1) != 0)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < SNAPSHOT_WORDS; i++)
+        {
+            words[i] = slot.Words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.Sequence.load(std::memory_order_relaxed) == sequence)
+        {
+            break;
+        }
+    }
+
+    InputSnapshot snapshot;
+    std::memcpy(static_cast<void *>(&snapshot), words.data(), sizeof(InputSnapshot));
+    return snapshot;
+}
+
+void ae::InputState::OnEvent(Event &event) noexcept
+{
+    switch (static_cast<EventType>(event.GetTypeId()))
+    {
+    case EventType::KEY_PRESSED:
+    {
+        const auto &keyEvent = static_cast<const KeyPressedEvent &>(event);
+
+        if (!keyEvent.IsRepeat() && !m_Current.IsKeyDown(keyEvent.GetKeyCode()))
+        {
+            SetBit(m_Current.KeysDown, keyEvent.GetKeyCode(), true);
+            SetBit(m_Current.KeysPressed, keyEvent.GetKeyCode(), true);
+        }
+
+        break;
+    }
+    case EventType::KEY_RELEASED:
+    {
+        const int32_t keyCode = static_cast<const KeyReleasedEvent &>(event).GetKeyCode();
+
+        if (m_Current.IsKeyDown(keyCode))
+        {
+            SetBit(m_Current.KeysDown, keyCode, false);
+            SetBit(m_Current.KeysReleased, keyCode, true);
+        }
+
+        break;
+    }
+    case EventType::MOUSE_BUTTON_PRESSED:
+    {
+        const int32_t button = static_cast<const MouseButtonPressedEvent &>(event).GetButton();
+
+        if (button >= 0 && button < InputSnapshot::MAX_MOUSE_BUTTONS && !m_Current.IsMouseButtonDown(button))
+        {
+            m_Current.ButtonsDown |= 1U << button;
+            m_Current.ButtonsPressed |= 1U << button;
+        }
+
+        break;
+    }
+    case EventType::MOUSE_BUTTON_RELEASED:
+    {
+        const int32_t button = static_cast<const MouseButtonReleasedEvent &>(event).GetButton();
+
+        if (m_Current.IsMouseButtonDown(button))
+        {
+            m_Current.ButtonsDown &= ~(1U << button);
+            m_Current.ButtonsReleased |= 1U << button;
+        }
+
+        break;
+    }
+    case EventType::MOUSE_MOVED:
+    {
+        const auto &mouseEvent = static_cast<const MouseMovedEvent &>(event);
+
+        // NOTE: The first position only sets the cursor, so the first frame does not see a jump from the origin
+        if (m_HasMousePosition)
+        {
+            m_Current.MouseDeltaX += mouseEvent.GetX() - m_Current.MouseX;
+            m_Current.MouseDeltaY += mouseEvent.GetY() - m_Current.MouseY;
+        }
+
+        m_Current.MouseX = mouseEvent.GetX();
+        m_Current.MouseY = mouseEvent.GetY();
+        m_HasMousePosition = true;
+        break;
+    }
+    case EventType::MOUSE_SCROLLED:
+    {
+        const auto &scrollEvent = static_cast<const MouseScrolledEvent &>(event);
+        m_Current.ScrollX += scrollEvent.GetXOffset();
+        m_Current.ScrollY += scrollEvent.GetYOffset();
+        break;
+    }
+    case EventType::MOUSE_ENTERED:
+        m_Current.MouseInWindow = true;
+        break;
+    case EventType::MOUSE_EXITED:
+        m_Current.MouseInWindow = false;
+        break;
+    case EventType::WINDOW_FOCUSED:
+        m_Current.WindowFocused = static_cast<const WindowFocusedEvent &>(event).IsFocused();
+
+        // NOTE: Releases go to the focused window, so keys held when focus is lost would otherwise stay down
+        if (!m_Current.WindowFocused)
+        {
+            ReleaseAll();
+        }
+
+        break;
+    case EventType::CONTROLLER_CONNECTED:
+    {
+        const int32_t controllerId = static_cast<const ControllerConnectedEvent &>(event).GetControllerId();
+
+        if (controllerId >= 0 && controllerId < InputSnapshot::MAX_CONTROLLERS)
+        {
+            m_Current.ControllersConnected |= 1U << controllerId;
+        }
+
+        break;
+    }
+    case EventType::CONTROLLER_DISCONNECTED:
+    {
+        const int32_t controllerId = static_cast<const ControllerDisconnectedEvent &>(event).GetControllerId();
+
+        if (controllerId >= 0 && controllerId < InputSnapshot::MAX_CONTROLLERS)
+        {
+            m_Current.ControllersConnected &= ~(1U << controllerId);
+        }
+
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void ae::InputState::ReleaseAll() noexcept
+{
+    for (size_t i = 0; i < InputSnapshot::KEY_WORDS; i++)
+    {
+        m_Current.KeysReleased[i] |= m_Current.KeysDown[i];
+        m_Current.KeysDown[i] = 0;
+    }
+
+    m_Current.ButtonsReleased |= m_Current.ButtonsDown;
+    m_Current.ButtonsDown = 0;
+}
+
+void ae::InputState::SetBit(std::array<uint64_t, InputSnapshot::KEY_WORDS> &keys, int32_t keyCode,
+                            bool value) noexcept
+{
+    if (keyCode < 0 || keyCode >= InputSnapshot::MAX_KEYS)
+    {
+        return;
+    }
+
+    const uint64_t mask = uint64_t(1) << (keyCode % 64);
+
+    if (value)
+    {
+        keys[keyCode / 64] |= mask;
+    }
+    else
+    {
+        keys[keyCode / 64] &= ~mask;
+    }
+}
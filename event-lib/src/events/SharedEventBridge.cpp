@@ -0,0 +1,402 @@
+#include "general/pch.h"
+
+#include "EventManager.h"
+#include "SharedEventBridge.h"
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <new>
+
+// NOTE: Shared memory layout, all values in host byte order so both processes must share an architecture:
+//     Header:  SharedEventRingHeader below, followed by the ring of Capacity bytes
+//     Record:  uint32_t Size, uint16_t TypeSlot, uint16_t Reserved, uint64_t TimestampNs, payload
+// Size covers the record header and payload, records start on RECORD_ALIGNMENT boundaries. A record that would cross
+// the end of the ring is preceded by a padding record filling the rest of it. Positions count bytes since the start
+// and only grow, the publisher owns WritePosition and the subscriber ReadPosition and SubscriberAttached. Timestamps
+// are std::chrono::steady_clock nanoseconds, comparable between processes on the same machine
+struct ae::detail::SharedEventRingHeader
+{
+    static constexpr uint32_t MAX_TYPES = 256;
+    static constexpr size_t MAX_TYPE_NAME_SIZE = 48; // NOTE: Including the terminating zero
+
+    std::atomic<uint32_t> Magic; // NOTE: Stored last by the publisher, so readers never see a half-initialized ring
+    uint32_t Version;
+    uint64_t Capacity;
+    std::atomic<uint32_t> TypeCount;
+    char TypeNames[MAX_TYPES][MAX_TYPE_NAME_SIZE];
+
+    // NOTE: On separate cache lines, so the two processes do not invalidate each other's writes
+    alignas(64) std::atomic<uint64_t> WritePosition;
+    std::atomic<uint64_t> DroppedCount;
+    alignas(64) std::atomic<uint64_t> ReadPosition;
+    std::atomic<uint32_t> SubscriberAttached; // NOTE: Nothing is written while it is zero
+};
+
+namespace
+{
+
+using RingHeader = ae::detail::SharedEventRingHeader;
+
+constexpr uint32_t BRIDGE_MAGIC = 0x42534541; // NOTE: "AESB"
+constexpr uint32_t BRIDGE_VERSION = 2;
+constexpr size_t RING_OFFSET = (sizeof(RingHeader) + 63) / 64 * 64;
+constexpr size_t RECORD_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint16_t) * 2 + sizeof(uint64_t);
+constexpr uint64_t RECORD_ALIGNMENT = RECORD_HEADER_SIZE; // NOTE: So the space left at the end always fits a header
+constexpr uint64_t MIN_CAPACITY = 4096;
+constexpr uint16_t PADDING_SLOT = UINT16_MAX;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared positions must be lock-free to be address-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared counters must be lock-free to be address-free");
+
+// NOTE: Set while a subscriber dispatches, so publishers on the same thread skip the events it ingests
+thread_local bool t_Ingesting = false;
+
+struct RecordHeader
+{
+    uint32_t Size = 0;
+    uint16_t TypeSlot = 0;
+    uint16_t Reserved = 0;
+    uint64_t TimestampNs = 0;
+};
+
+static_assert(sizeof(RecordHeader) == RECORD_HEADER_SIZE, "RecordHeader must match the shared record layout");
+
+constexpr uint64_t AlignRecord(uint64_t size) noexcept
+{
+    return (size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+
+} // namespace
+
+ae::SharedEventPublisher::SharedEventPublisher() : SharedEventPublisher(EventManager::Get()) {}
+
+ae::SharedEventPublisher::SharedEventPublisher(EventBus &bus) noexcept : m_Bus(bus) {}
+
+ae::SharedEventPublisher::~SharedEventPublisher()
+{
+    Stop();
+}
+
+bool ae::SharedEventPublisher::Start(const std::string &name, size_t capacity)
+{
+    Stop();
+
+    const uint64_t ringCapacity = std::bit_ceil(std::max<uint64_t>(capacity, MIN_CAPACITY));
+
+    if (!m_Memory.Create(name, RING_OFFSET + ringCapacity))
+    {
+        return false;
+    }
+
+    std::byte *pData = m_Memory.GetData().data();
+    m_pHeader = new (pData) RingHeader();
+    m_pHeader->Version = BRIDGE_VERSION;
+    m_pHeader->Capacity = ringCapacity;
+    m_pHeader->Magic.store(BRIDGE_MAGIC, std::memory_order_release);
+
+    m_pRing = pData + RING_OFFSET;
+    m_Capacity = ringCapacity;
+    m_TypeSlots.assign(GetEventTypeCount(), UNASSIGNED_SLOT);
+    m_PublishedEventCount = 0;
+
+    m_Listener.emplace(m_Bus, EventDelegate::Bind<&SharedEventPublisher::OnEvent>(this));
+    m_Listener->SetPriority(EventBus::OBSERVER_PRIORITY);
+
+    AE_LOG(AE_TRACE, "Started publishing events to shared memory '{}'", name);
+    return true;
+}
+
+void ae::SharedEventPublisher::Stop()
+{
+    if (m_pHeader == nullptr)
+    {
+        return;
+    }
+
+    m_Listener.reset();
+    m_Memory.Close();
+    m_pHeader = nullptr;
+    m_pRing = nullptr;
+    m_Capacity = 0;
+
+    AE_LOG(AE_TRACE, "Stopped publishing events after {} events", m_PublishedEventCount);
+}
+
+uint64_t ae::SharedEventPublisher::GetDroppedEventCount() const noexcept
+{
+    return m_pHeader != nullptr ? m_pHeader->DroppedCount.load(std::memory_order_relaxed) : 0;
+}
+
+bool ae::SharedEventPublisher::HasSubscriber() const noexcept
+{
+    return m_pHeader != nullptr && m_pHeader->SubscriberAttached.load(std::memory_order_acquire) != 0;
+}
+
+void ae::SharedEventPublisher::OnEvent(Event &event)
+{
+    const uint32_t typeIndex = detail::GetEventTypeIndex(event.GetTypeId());
+
+    // NOTE: Without a subscriber the ring would only fill up once and then count every event as dropped
+    if (t_Ingesting || typeIndex == detail::INVALID_EVENT_TYPE_INDEX || !HasSubscriber())
+    {
+        return;
+    }
+
+    if (typeIndex >= m_TypeSlots.size())
+    {
+        m_TypeSlots.resize(typeIndex + 1, UNASSIGNED_SLOT);
+    }
+
+    const detail::RecordableEventType *pType = detail::FindRecordableEventType(event.GetTypeId());
+
+    if (pType == nullptr)
+    {
+        if (m_TypeSlots[typeIndex] != SKIPPED_SLOT)
+        {
+            AE_LOG(AE_WARNING, "Event type {} has no EventSerialization and is not published", event.GetTypeId());
+            m_TypeSlots[typeIndex] = SKIPPED_SLOT;
+        }
+
+        return;
+    }
+
+    const uint16_t typeSlot = GetTypeSlot(typeIndex, *pType);
+
+    if (typeSlot == SKIPPED_SLOT)
+    {
+        return;
+    }
+
+    const uint64_t timestampNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+
+    m_Payload.clear();
+    EventWriter writer(m_Payload);
+    pType->pWrite(event, writer);
+
+    if (WriteRecord(typeSlot, timestampNs))
+    {
+        m_PublishedEventCount++;
+    }
+}
+
+uint16_t ae::SharedEventPublisher::GetTypeSlot(uint32_t typeIndex, const detail::RecordableEventType &type)
+{
+    uint16_t &typeSlot = m_TypeSlots[typeIndex];
+
+    if (typeSlot != UNASSIGNED_SLOT)
+    {
+        return typeSlot;
+    }
+
+    const uint32_t typeCount = m_pHeader->TypeCount.load(std::memory_order_relaxed);
+
+    if (typeCount == RingHeader::MAX_TYPES || type.Name.size() >= RingHeader::MAX_TYPE_NAME_SIZE)
+    {
+        AE_LOG(AE_WARNING, "Event type '{}' does not fit the shared type table and is not published", type.Name);
+        typeSlot = SKIPPED_SLOT;
+        return typeSlot;
+    }
+
+    // NOTE: The memory is zero-filled, so the name is terminated. Readers see it through the release of the record
+    std::memcpy(m_pHeader->TypeNames[typeCount], type.Name.data(), type.Name.size());
+    m_pHeader->TypeCount.store(typeCount + 1, std::memory_order_release);
+
+    typeSlot = static_cast<uint16_t>(typeCount);
+    return typeSlot;
+}
+
+bool ae::SharedEventPublisher::WriteRecord(uint16_t typeSlot, uint64_t timestampNs)
+{
+    const uint64_t size = RECORD_HEADER_SIZE + m_Payload.size();
+    const uint64_t recordSize = AlignRecord(size);
+    const uint64_t writePosition = m_pHeader->WritePosition.load(std::memory_order_relaxed);
+    const uint64_t readPosition = m_pHeader->ReadPosition.load(std::memory_order_acquire);
+
+    const uint64_t offset = writePosition & (m_Capacity - 1);
+    const uint64_t spaceToEnd = m_Capacity - offset;
+    const uint64_t padding = recordSize > spaceToEnd ? spaceToEnd : 0;
+
+    if (size > std::numeric_limits<uint32_t>::max() ||
+        padding + recordSize > m_Capacity - (writePosition - readPosition))
+    {
+        m_pHeader->DroppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (padding != 0)
+    {
+        const RecordHeader paddingHeader{ .Size = static_cast<uint32_t>(padding), .TypeSlot = PADDING_SLOT };
+        std::memcpy(m_pRing + offset, &paddingHeader, sizeof(paddingHeader));
+    }
+
+    const uint64_t recordOffset = (offset + padding) & (m_Capacity - 1);
+    const RecordHeader header{ .Size = static_cast<uint32_t>(size), .TypeSlot = typeSlot, .TimestampNs = timestampNs };
+    std::memcpy(m_pRing + recordOffset, &header, sizeof(header));
+    std::memcpy(m_pRing + recordOffset + RECORD_HEADER_SIZE, m_Payload.data(), m_Payload.size());
+
+    // NOTE: Publishes the record, and the type name written before it, to the subscriber
+    m_pHeader->WritePosition.store(writePosition + padding + recordSize, std::memory_order_release);
+    return true;
+}
+
+bool ae::SharedEventSubscriber::Open(const std::string &name)
+{
+    Close();
+
+    if (!m_Memory.Open(name))
+    {
+        return false;
+    }
+
+    const std::span<std::byte> data = m_Memory.GetData();
+    auto *pHeader = std::launder(reinterpret_cast<RingHeader *>(data.data()));
+
+    if (data.size() < RING_OFFSET || pHeader->Magic.load(std::memory_order_acquire) != BRIDGE_MAGIC)
+    {
+        AE_LOG(AE_WARNING, "Shared memory '{}' is not an event bridge", name);
+        m_Memory.Close();
+        return false;
+    }
+
+    if (pHeader->Version != BRIDGE_VERSION || !std::has_single_bit(pHeader->Capacity) ||
+        pHeader->Capacity > data.size() - RING_OFFSET)
+    {
+        AE_LOG(AE_WARNING, "Event bridge '{}' has version {}, expected {}", name, pHeader->Version, BRIDGE_VERSION);
+        m_Memory.Close();
+        return false;
+    }
+
+    // NOTE: Starts at the end, a subscriber attaching late must not dispatch old events as if they were live. Records
+    // a previous subscriber left unread are skipped for the same reason
+    if (pHeader->SubscriberAttached.exchange(1, std::memory_order_acq_rel) != 0)
+    {
+        AE_LOG(AE_WARNING, "Event bridge '{}' already had a subscriber, taking over from it", name);
+    }
+
+    pHeader->ReadPosition.store(pHeader->WritePosition.load(std::memory_order_acquire), std::memory_order_release);
+
+    m_pHeader = pHeader;
+    m_pRing = data.data() + RING_OFFSET;
+    m_Capacity = pHeader->Capacity;
+    return true;
+}
+
+void ae::SharedEventSubscriber::Close() noexcept
+{
+    if (m_pHeader != nullptr)
+    {
+        m_pHeader->SubscriberAttached.store(0, std::memory_order_release);
+    }
+
+    m_Memory.Close();
+    m_pHeader = nullptr;
+    m_pRing = nullptr;
+    m_Capacity = 0;
+    m_Types.clear();
+}
+
+uint64_t ae::SharedEventSubscriber::GetDroppedEventCount() const noexcept
+{
+    return m_pHeader != nullptr ? m_pHeader->DroppedCount.load(std::memory_order_relaxed) : 0;
+}
+
+size_t ae::SharedEventSubscriber::Poll(EventDelegate target)
+{
+    if (m_pHeader == nullptr || t_Ingesting)
+    {
+        return 0;
+    }
+
+    uint64_t readPosition = m_pHeader->ReadPosition.load(std::memory_order_relaxed);
+    const uint64_t writePosition = m_pHeader->WritePosition.load(std::memory_order_acquire);
+    size_t dispatchedCount = 0;
+
+    t_Ingesting = true;
+
+    while (readPosition != writePosition)
+    {
+        const uint64_t offset = readPosition & (m_Capacity - 1);
+        RecordHeader header;
+        std::memcpy(&header, m_pRing + offset, sizeof(header));
+
+        const uint64_t recordSize = header.TypeSlot == PADDING_SLOT ? header.Size : AlignRecord(header.Size);
+
+        // NOTE: The other process may be buggy or hostile, a record must stay inside what it published
+        if (header.Size < RECORD_HEADER_SIZE || recordSize > m_Capacity - offset ||
+            recordSize > writePosition - readPosition)
+        {
+            AE_LOG(AE_WARNING, "Skipped a corrupt event bridge, discarding everything published so far");
+            readPosition = writePosition;
+            break;
+        }
+
+        if (header.TypeSlot != PADDING_SLOT)
+        {
+            SharedType &type = ResolveType(header.TypeSlot);
+
+            if (type.TypeIndex != detail::INVALID_EVENT_TYPE_INDEX)
+            {
+                const detail::RecordableEventType &recordableType = detail::GetRecordableEventType(type.TypeIndex);
+                const std::span<const std::byte> payload(m_pRing + offset + RECORD_HEADER_SIZE,
+                                                         header.Size - RECORD_HEADER_SIZE);
+                EventReader reader(payload, m_Strings);
+
+                if (recordableType.pReplay(reader, target))
+                {
+                    dispatchedCount++;
+                }
+                else if (!type.Warned)
+                {
+                    AE_LOG(AE_WARNING, "Skipped a corrupt '{}' event from the event bridge", recordableType.Name);
+                    type.Warned = true;
+                }
+            }
+        }
+
+        readPosition += recordSize;
+    }
+
+    t_Ingesting = false;
+
+    // NOTE: Hands the space back only now, the records were read in place while dispatching
+    m_pHeader->ReadPosition.store(readPosition, std::memory_order_release);
+    return dispatchedCount;
+}
+
+ae::SharedEventSubscriber::SharedType &ae::SharedEventSubscriber::ResolveType(uint16_t typeSlot)
+{
+    if (typeSlot >= m_Types.size())
+    {
+        m_Types.resize(typeSlot + 1);
+    }
+
+    SharedType &type = m_Types[typeSlot];
+
+    if (type.Resolved)
+    {
+        return type;
+    }
+
+    type.Resolved = true;
+
+    if (typeSlot >= std::min(m_pHeader->TypeCount.load(std::memory_order_acquire), RingHeader::MAX_TYPES))
+    {
+        AE_LOG(AE_WARNING, "Event bridge uses type slot {} before defining it, its events are skipped", typeSlot);
+        return type;
+    }
+
+    std::string_view name(m_pHeader->TypeNames[typeSlot], RingHeader::MAX_TYPE_NAME_SIZE);
+    name = name.substr(0, name.find('\0'));
+    type.TypeIndex = detail::FindRecordableEventTypeIndex(name);
+
+    if (type.TypeIndex == detail::INVALID_EVENT_TYPE_INDEX)
+    {
+        AE_LOG(AE_WARNING, "Shared event type '{}' is not registered, its events are skipped", name);
+    }
+
+    return type;
+}
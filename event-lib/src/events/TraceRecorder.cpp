@@ -0,0 +1,223 @@
+#include "general/pch.h"
+
+#include "TraceRecorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+
+void WriteEscaped(std::ostream &stream, std::string_view string)
+{
+    for (const char character : string)
+    {
+        switch (character)
+        {
+        case '"':
+            stream << "\\\"";
+            break;
+        case '\\':
+            stream << "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(character));
+                stream << escaped;
+            }
+            else
+            {
+                stream << character;
+            }
+            break;
+        }
+    }
+}
+
+} // namespace
+
+void ae::TraceRecorder::Start(size_t spansPerThread)
+{
+    const std::lock_guard lock(m_BuffersMutex);
+
+    m_SpansPerThread = std::max<size_t>(spansPerThread, 1);
+
+    // NOTE: Buffers stay registered to their threads across sessions, only their storage is reset
+    for (const auto &pBuffer : m_Buffers)
+    {
+        if (pBuffer->Capacity != m_SpansPerThread)
+        {
+            pBuffer->pSpans = std::make_unique_for_overwrite<Span[]>(m_SpansPerThread);
+            pBuffer->Capacity = m_SpansPerThread;
+        }
+
+        pBuffer->Count.store(0, std::memory_order_relaxed);
+        pBuffer->Dropped.store(0, std::memory_order_relaxed);
+    }
+
+    m_Calibration.Start();
+    m_Recording.store(true, std::memory_order_release);
+
+    AE_LOG(AE_TRACE, "Started TraceRecorder with {} spans per thread", m_SpansPerThread);
+}
+
+void ae::TraceRecorder::Stop() noexcept
+{
+    m_Recording.store(false, std::memory_order_release);
+}
+
+void ae::TraceRecorder::RecordSpan(std::string_view name, const char *pCategory, uint64_t startTicks,
+                                   uint64_t endTicks)
+{
+    ThreadBuffer &buffer = GetThreadBuffer();
+    const size_t count = buffer.Count.load(std::memory_order_relaxed);
+
+    if (count == buffer.Capacity)
+    {
+        buffer.Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Span &span = buffer.pSpans[count];
+    span.StartTicks = startTicks;
+    span.EndTicks = endTicks;
+    span.pCategory = pCategory;
+
+    const size_t length = std::min(name.size(), MAX_SPAN_NAME_LENGTH);
+    std::memcpy(span.Name, name.data(), length);
+    span.Name[length] = '\0';
+
+    buffer.Count.store(count + 1, std::memory_order_release);
+}
+
+void ae::TraceRecorder::RecordEventSpan(uint32_t typeId, uint64_t startTicks, uint64_t endTicks)
+{
+    if (typeId < static_cast<uint32_t>(EventType::CUSTOM_START))
+    {
+        RecordSpan(GetEventTypeName(typeId), "event", startTicks, endTicks);
+        return;
+    }
+
+    char name[MAX_SPAN_NAME_LENGTH + 1];
+    const int length = std::snprintf(name, sizeof(name), "Custom %u", typeId);
+    RecordSpan(std::string_view(name, static_cast<size_t>(length)), "event", startTicks, endTicks);
+}
+
+void ae::TraceRecorder::WriteChromeTrace(std::ostream &stream) const
+{
+    const std::lock_guard lock(m_BuffersMutex);
+
+    const double microsecondsPerTick = m_Calibration.GetNanosecondsPerTick() / 1000.0;
+    const uint64_t startTicks = m_Calibration.GetStartTicks();
+    bool first = true;
+
+    // NOTE: Fixed notation, the default precision would print long recordings in scientific notation
+    const std::ios_base::fmtflags flags = stream.flags();
+    const std::streamsize precision = stream.precision();
+    stream << std::fixed << std::setprecision(3);
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    for (const auto &pBuffer : m_Buffers)
+    {
+        stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+               << pBuffer->ThreadIndex << ",\"args\":{\"name\":\"Thread " << pBuffer->ThreadIndex << "\"}}";
+        first = false;
+
+        const size_t count = pBuffer->Count.load(std::memory_order_acquire);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const Span &span = pBuffer->pSpans[i];
+
+            // NOTE: Signed, the TSC of another core may read slightly behind the one that started the recording
+            const auto start = static_cast<int64_t>(span.StartTicks - startTicks);
+            const uint64_t duration = span.EndTicks > span.StartTicks ? span.EndTicks - span.StartTicks : 0;
+
+            stream << ",\n{\"name\":\"";
+            WriteEscaped(stream, span.Name);
+            stream << "\",\"cat\":\"" << span.pCategory << "\",\"ph\":\"X\",\"ts\":"
+                   << static_cast<double>(start) * microsecondsPerTick
+                   << ",\"dur\":" << static_cast<double>(duration) * microsecondsPerTick
+                   << ",\"pid\":1,\"tid\":" << pBuffer->ThreadIndex << "}";
+        }
+    }
+
+    stream << "\n]}\n";
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+bool ae::TraceRecorder::ExportChromeTrace(const std::string &path) const
+{
+    std::ofstream file(path);
+
+    if (!file)
+    {
+        AE_LOG(AE_WARNING, "Failed to open '{}' for writing the trace", path);
+        return false;
+    }
+
+    WriteChromeTrace(file);
+
+    if (!file)
+    {
+        AE_LOG(AE_WARNING, "Failed to write the trace to '{}'", path);
+        return false;
+    }
+
+    AE_LOG(AE_INFO, "Exported {} trace spans to '{}'", GetSpanCount(), path);
+    return true;
+}
+
+size_t ae::TraceRecorder::GetSpanCount() const
+{
+    const std::lock_guard lock(m_BuffersMutex);
+    size_t count = 0;
+
+    for (const auto &pBuffer : m_Buffers)
+    {
+        count += pBuffer->Count.load(std::memory_order_acquire);
+    }
+
+    return count;
+}
+
+uint64_t ae::TraceRecorder::GetDroppedSpanCount() const
+{
+    const std::lock_guard lock(m_BuffersMutex);
+    uint64_t count = 0;
+
+    for (const auto &pBuffer : m_Buffers)
+    {
+        count += pBuffer->Dropped.load(std::memory_order_relaxed);
+    }
+
+    return count;
+}
+
+ae::TraceRecorder::ThreadBuffer &ae::TraceRecorder::GetThreadBuffer()
+{
+    // NOTE: There is a single recorder, so each thread keeps a pointer to its buffer for the lifetime of the program
+    thread_local ThreadBuffer *t_pBuffer = nullptr;
+
+    if (t_pBuffer == nullptr)
+    {
+        const std::lock_guard lock(m_BuffersMutex);
+
+        auto pBuffer = std::make_unique<ThreadBuffer>();
+        pBuffer->pSpans = std::make_unique_for_overwrite<Span[]>(m_SpansPerThread);
+        pBuffer->Capacity = m_SpansPerThread;
+        pBuffer->ThreadIndex = static_cast<uint32_t>(m_Buffers.size() + 1);
+
+        t_pBuffer = pBuffer.get();
+        m_Buffers.push_back(std::move(pBuffer));
+    }
+
+    return *t_pBuffer;
+}
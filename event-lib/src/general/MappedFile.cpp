@@ -0,0 +1,130 @@
+#include "general/pch.h"
+
+#include "MappedFile.h"
+
+#ifdef AE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ae::MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool ae::MappedFile::Open(const std::string &path)
+{
+    Close();
+
+#ifdef AE_WINDOWS
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        AE_LOG(AE_WARNING, "Failed to open '{}' for mapping", path);
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    m_pFileHandle = file;
+    m_Size = static_cast<size_t>(size.QuadPart);
+
+    // NOTE: Empty files cannot be mapped, they are open with no data
+    if (m_Size != 0)
+    {
+        m_pMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void *pView =
+            m_pMappingHandle != nullptr ? MapViewOfFile(m_pMappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        if (pView == nullptr)
+        {
+            AE_LOG(AE_WARNING, "Failed to map '{}'", path);
+            Close();
+            return false;
+        }
+
+        m_pData = static_cast<const std::byte *>(pView);
+    }
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+
+    if (file == -1)
+    {
+        AE_LOG(AE_WARNING, "Failed to open '{}' for mapping", path);
+        return false;
+    }
+
+    struct stat status{};
+
+    if (fstat(file, &status) != 0)
+    {
+        AE_LOG(AE_WARNING, "Failed to read the size of '{}'", path);
+        close(file);
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(status.st_size);
+
+    // NOTE: Empty files cannot be mapped, they are open with no data. The mapping outlives the descriptor
+    if (m_Size != 0)
+    {
+        void *pView = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (pView == MAP_FAILED)
+        {
+            AE_LOG(AE_WARNING, "Failed to map '{}'", path);
+            close(file);
+            m_Size = 0;
+            return false;
+        }
+
+        madvise(pView, m_Size, MADV_SEQUENTIAL);
+        m_pData = static_cast<const std::byte *>(pView);
+    }
+
+    close(file);
+#endif
+
+    m_IsOpen = true;
+    return true;
+}
+
+void ae::MappedFile::Close() noexcept
+{
+#ifdef AE_WINDOWS
+    if (m_pData != nullptr)
+    {
+        UnmapViewOfFile(m_pData);
+    }
+
+    if (m_pMappingHandle != nullptr)
+    {
+        CloseHandle(m_pMappingHandle);
+    }
+
+    if (m_pFileHandle != nullptr)
+    {
+        CloseHandle(m_pFileHandle);
+    }
+
+    m_pMappingHandle = nullptr;
+    m_pFileHandle = nullptr;
+#else
+    if (m_pData != nullptr)
+    {
+        munmap(const_cast<std::byte *>(m_pData), m_Size);
+    }
+#endif
+
+    m_pData = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
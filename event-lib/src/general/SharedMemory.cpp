@@ -0,0 +1,211 @@
+#include "general/pch.h"
+
+#include "SharedMemory.h"
+
+#ifdef AE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+#ifndef AE_WINDOWS
+std::string GetPosixName(const std::string &name)
+{
+    return name.starts_with('/') ? name : "/" + name;
+}
+#endif
+
+} // namespace
+
+ae::SharedMemory::~SharedMemory()
+{
+    Close();
+}
+
+bool ae::SharedMemory::Create(const std::string &name, size_t size)
+{
+    Close();
+
+    if (size == 0)
+    {
+        AE_LOG(AE_WARNING, "Tried to create shared memory '{}' without a size", name);
+        return false;
+    }
+
+#ifdef AE_WINDOWS
+    const auto size64 = static_cast<uint64_t>(size);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), name.c_str());
+
+    if (mapping == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Failed to create shared memory '{}'", name);
+        return false;
+    }
+
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        AE_LOG(AE_WARNING, "Tried to create shared memory '{}' that another process already created", name);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    void *pView = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+    if (pView == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Failed to map shared memory '{}'", name);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_pMappingHandle = mapping;
+#else
+    const std::string posixName = GetPosixName(name);
+    int file = shm_open(posixName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    // NOTE: Left behind by an owner that did not close it, typically a crash
+    if (file == -1 && errno == EEXIST)
+    {
+        AE_LOG(AE_TRACE, "Replacing stale shared memory '{}'", name);
+        shm_unlink(posixName.c_str());
+        file = shm_open(posixName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+
+    if (file == -1)
+    {
+        AE_LOG(AE_WARNING, "Failed to create shared memory '{}'", name);
+        return false;
+    }
+
+    void *pView = ftruncate(file, static_cast<off_t>(size)) == 0
+                      ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0)
+                      : MAP_FAILED;
+    close(file);
+
+    if (pView == MAP_FAILED)
+    {
+        AE_LOG(AE_WARNING, "Failed to map shared memory '{}'", name);
+        shm_unlink(posixName.c_str());
+        return false;
+    }
+
+    m_Name = posixName;
+#endif
+
+    m_pData = static_cast<std::byte *>(pView);
+    m_Size = size;
+    m_IsOpen = true;
+    m_IsOwner = true;
+    return true;
+}
+
+bool ae::SharedMemory::Open(const std::string &name)
+{
+    Close();
+
+#ifdef AE_WINDOWS
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+
+    if (mapping == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Failed to open shared memory '{}'", name);
+        return false;
+    }
+
+    void *pView = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info{};
+
+    if (pView == nullptr || VirtualQuery(pView, &info, sizeof(info)) == 0)
+    {
+        AE_LOG(AE_WARNING, "Failed to map shared memory '{}'", name);
+
+        if (pView != nullptr)
+        {
+            UnmapViewOfFile(pView);
+        }
+
+        CloseHandle(mapping);
+        return false;
+    }
+
+    // NOTE: Rounded up to whole pages, the creator's size is not stored by Windows
+    m_pMappingHandle = mapping;
+    m_Size = static_cast<size_t>(info.RegionSize);
+#else
+    const int file = shm_open(GetPosixName(name).c_str(), O_RDWR, 0);
+
+    if (file == -1)
+    {
+        AE_LOG(AE_WARNING, "Failed to open shared memory '{}'", name);
+        return false;
+    }
+
+    struct stat status{};
+    void *pView = MAP_FAILED;
+
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        pView = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    }
+
+    close(file);
+
+    if (pView == MAP_FAILED)
+    {
+        AE_LOG(AE_WARNING, "Failed to map shared memory '{}'", name);
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(status.st_size);
+#endif
+
+    m_pData = static_cast<std::byte *>(pView);
+    m_IsOpen = true;
+    m_IsOwner = false;
+    return true;
+}
+
+void ae::SharedMemory::Close() noexcept
+{
+#ifdef AE_WINDOWS
+    if (m_pData != nullptr)
+    {
+        UnmapViewOfFile(m_pData);
+    }
+
+    if (m_pMappingHandle != nullptr)
+    {
+        CloseHandle(m_pMappingHandle);
+    }
+
+    m_pMappingHandle = nullptr;
+#else
+    if (m_pData != nullptr)
+    {
+        munmap(m_pData, m_Size);
+    }
+
+    // NOTE: Processes that still have it mapped keep their mapping, only the name goes away
+    if (m_IsOwner)
+    {
+        shm_unlink(m_Name.c_str());
+    }
+
+    m_Name.clear();
+#endif
+
+    m_pData = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+    m_IsOwner = false;
+}
@@ -7,4 +7,54 @@ namespace ae
 
 Layer::Layer(const std::string &name) : m_Name(name), m_Enabled(true) {}
 
+void Layer::SetEnabled(bool enabled) noexcept
+{
+    if (m_Enabled == enabled)
+    {
+        return;
+    }
+
+    m_Enabled = enabled;
+    OnEventInterestChanged();
+    OnHooksChanged();
+}
+
+bool Layer::HandlesEvent(uint32_t typeId, EventCategoryWrapper categories) const noexcept
+{
+    if (HandlesAllEvents() || (m_EventCategories & categories) != EventCategory::NONE)
+    {
+        return true;
+    }
+
+    return std::ranges::find(m_EventTypeIds, typeId) != m_EventTypeIds.end();
+}
+
+void Layer::SubscribeToCategories(EventCategoryWrapper categories)
+{
+    m_EventCategories |= categories;
+    OnEventInterestChanged();
+}
+
+void Layer::DeclareHooks(LayerHook hooks) noexcept
+{
+    m_DeclaredHooks = hooks;
+    OnHooksChanged();
+}
+
+void Layer::OnEventInterestChanged() noexcept
+{
+    if (m_pLayerStack != nullptr)
+    {
+        m_pLayerStack->InvalidateEventRoutes();
+    }
+}
+
+void Layer::OnHooksChanged() noexcept
+{
+    if (m_pLayerStack != nullptr)
+    {
+        m_pLayerStack->InvalidatePhases();
+    }
+}
+
 } // namespace ae
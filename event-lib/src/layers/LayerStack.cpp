@@ -1,14 +1,52 @@
 #include "general/pch.h"
 
 #include "Event.h"
+#include "EventInstrumentation.h"
 #include "Layer.h"
+#include "TraceRecorder.h"
 
 #include <algorithm>
 #include <ranges>
+#include <string_view>
+
+namespace
+{
+
+// NOTE: Runs a layer callback, recording it as a span named after the layer while a trace is being recorded
+template <typename Callback> void InvokeTraced(const ae::Layer *pLayer, const char *pCategory, Callback &&callback)
+{
+#ifdef AE_EVENT_INSTRUMENTATION
+    ae::TraceRecorder &traceRecorder = ae::TraceRecorder::Get();
+
+    if (traceRecorder.IsRecording())
+    {
+        // NOTE: Copied first, the callback may remove and delete its own layer. Longer names are truncated anyway
+        char name[ae::TraceRecorder::MAX_SPAN_NAME_LENGTH];
+        const size_t length = pLayer->GetName().copy(name, sizeof(name));
+        const uint64_t start = ae::EventInstrumentation::ReadTimestamp();
+        callback();
+        traceRecorder.RecordSpan(std::string_view(name, length), pCategory, start,
+                                 ae::EventInstrumentation::ReadTimestamp());
+        return;
+    }
+#else
+    static_cast<void>(pLayer);
+    static_cast<void>(pCategory);
+#endif
+
+    callback();
+}
+
+} // namespace
 
 ae::LayerStack::LayerStack()
 {
-    m_Listener.SetCallback([this](Event &event) { OnEvent(event); });
+#ifdef AE_EVENT_INSTRUMENTATION
+    // NOTE: Constructed first so it outlives the stack, which reports its layers to it on destruction
+    static_cast<void>(EventInstrumentation::Get());
+#endif
+
+    m_Listener.SetCallback(EventDelegate::Bind<&LayerStack::OnEvent>(this));
 }
 
 ae::LayerStack::~LayerStack()
@@ -17,33 +55,42 @@ ae::LayerStack::~LayerStack()
     {
         if (pLayer != nullptr)
         {
+            pLayer->m_pLayerStack = nullptr;
+            pLayer->m_StackIndex = Layer::INVALID_STACK_INDEX;
+#ifdef AE_EVENT_INSTRUMENTATION
+            EventInstrumentation::Get().OnLayerDetached(pLayer);
+#endif
             pLayer->OnDetach();
         }
     }
+
+    // NOTE: Queued layers were never attached
+    for (const PendingLayer &pending : m_PendingLayers)
+    {
+        if (pending.pLayer != nullptr)
+        {
+            pending.pLayer->m_pLayerStack = nullptr;
+        }
+    }
 }
 
-void ae::LayerStack::PushLayer(Layer *pLayer)
+ae::LayerHandle ae::LayerStack::PushLayer(Layer *pLayer)
 {
     if (pLayer == nullptr)
     {
         AE_LOG(AE_WARNING, "Tried to push null layer to LayerStack");
-        return;
+        return LayerHandle{};
     }
 
-#ifdef AE_DEBUG
-    if (std::ranges::find(m_Layers, pLayer) != m_Layers.end())
+    if (pLayer->m_pLayerStack != nullptr)
     {
-        AE_LOG(AE_WARNING, "Tried to push layer '{}' that is already in the stack", pLayer->GetName());
-        return;
+        AE_LOG(AE_WARNING, "Tried to push layer '{}' that is already in a stack", pLayer->GetName());
+        return LayerHandle{};
     }
-#endif
-
-    // NOTE: Insert before overlays
-    m_Layers.insert(m_Layers.begin() + m_LayerInsertIndex, pLayer);
-    m_LayerInsertIndex++;
-    pLayer->OnAttach();
 
+    const LayerHandle handle = Register(pLayer, false);
     AE_LOG(AE_TRACE, "Pushed layer: {}", pLayer->GetName());
+    return handle;
 }
 
 void ae::LayerStack::PopLayer(Layer *pLayer)
@@ -54,13 +101,9 @@ void ae::LayerStack::PopLayer(Layer *pLayer)
         return;
     }
 
-    auto it = std::find(m_Layers.begin(), m_Layers.begin() + m_LayerInsertIndex, pLayer);
-    if (it != m_Layers.begin() + m_LayerInsertIndex)
+    if (pLayer->m_pLayerStack == this && !m_Slots[pLayer->m_Handle.Index].Overlay)
     {
-        pLayer->OnDetach();
-        m_Layers.erase(it);
-        m_LayerInsertIndex--;
-
+        Unregister(pLayer);
         AE_LOG(AE_TRACE, "Popped layer: {}", pLayer->GetName());
     }
     else
@@ -69,27 +112,23 @@ void ae::LayerStack::PopLayer(Layer *pLayer)
     }
 }
 
-void ae::LayerStack::PushOverlay(Layer *pOverlay)
+ae::LayerHandle ae::LayerStack::PushOverlay(Layer *pOverlay)
 {
     if (pOverlay == nullptr)
     {
         AE_LOG(AE_WARNING, "Tried to push null overlay to LayerStack");
-        return;
+        return LayerHandle{};
     }
 
-#ifdef AE_DEBUG
-    if (std::ranges::find(m_Layers, pOverlay) != m_Layers.end())
+    if (pOverlay->m_pLayerStack != nullptr)
     {
-        AE_LOG(AE_WARNING, "Tried to push overlay '{}' that is already in the stack", pOverlay->GetName());
-        return;
+        AE_LOG(AE_WARNING, "Tried to push overlay '{}' that is already in a stack", pOverlay->GetName());
+        return LayerHandle{};
     }
-#endif
-
-    // NOTE: Overlays go at the end
-    m_Layers.push_back(pOverlay);
-    pOverlay->OnAttach();
 
+    const LayerHandle handle = Register(pOverlay, true);
     AE_LOG(AE_TRACE, "Pushed overlay: {}", pOverlay->GetName());
+    return handle;
 }
 
 void ae::LayerStack::PopOverlay(Layer *pOverlay)
@@ -100,12 +139,9 @@ void ae::LayerStack::PopOverlay(Layer *pOverlay)
         return;
     }
 
-    auto it = std::find(m_Layers.begin() + m_LayerInsertIndex, m_Layers.end(), pOverlay);
-    if (it != m_Layers.end())
+    if (pOverlay->m_pLayerStack == this && m_Slots[pOverlay->m_Handle.Index].Overlay)
     {
-        pOverlay->OnDetach();
-        m_Layers.erase(it);
-
+        Unregister(pOverlay);
         AE_LOG(AE_TRACE, "Popped overlay: {}", pOverlay->GetName());
     }
     else
@@ -114,55 +150,506 @@ void ae::LayerStack::PopOverlay(Layer *pOverlay)
     }
 }
 
+bool ae::LayerStack::Remove(LayerHandle handle)
+{
+    Layer *pLayer = Get(handle);
+
+    if (pLayer == nullptr)
+    {
+        AE_LOG(AE_WARNING, "Tried to remove a layer through a stale LayerHandle");
+        return false;
+    }
+
+    Unregister(pLayer);
+    AE_LOG(AE_TRACE, "Removed layer: {}", pLayer->GetName());
+    return true;
+}
+
+ae::Layer *ae::LayerStack::Get(LayerHandle handle) const noexcept
+{
+    if (handle.Index >= m_Slots.size() || m_Slots[handle.Index].Generation != handle.Generation)
+    {
+        return nullptr;
+    }
+
+    return m_Slots[handle.Index].pLayer;
+}
+
+void ae::LayerStack::ApplyPendingChanges()
+{
+    if (IsIterating())
+    {
+        return;
+    }
+
+    if (m_RemovedCount > 0)
+    {
+        CompactLayers();
+    }
+
+    // NOTE: OnAttach() may push or remove layers. Pushes go straight in, since nothing is iterating, and removals of
+    // queued layers clear their entry, so the queue is walked by index
+    for (size_t i = 0; i < m_PendingLayers.size(); i++)
+    {
+        const PendingLayer pending = m_PendingLayers[i];
+
+        if (pending.pLayer != nullptr)
+        {
+            Insert(pending.pLayer, pending.Overlay);
+        }
+    }
+
+    m_PendingLayers.clear();
+}
+
 void ae::LayerStack::OnEvent(Event &event)
 {
-    // NOTE: Events propagate top-to-bottom
-    for (auto *pLayer : std::ranges::reverse_view(m_Layers))
+    if (HasPendingChanges() && !IsIterating())
+    {
+        ApplyPendingChanges();
+    }
+
+    // NOTE: Routes can only be rebuilt when no dispatch is iterating them
+    if (m_EventRoutesDirty && m_DispatchDepth == 0)
     {
-        if (event.IsConsumed())
+        for (EventRoute &route : m_EventRoutes)
         {
-            break;
+            route.Layers.clear();
+            route.Built = false;
         }
 
-        if (pLayer != nullptr && pLayer->IsEnabled())
+        m_EventRoutesDirty = false;
+    }
+
+    m_DispatchDepth++;
+
+    const uint32_t typeIndex = detail::GetEventTypeIndex(event.GetTypeId());
+
+    if (!m_EventRoutesDirty && typeIndex != detail::INVALID_EVENT_TYPE_INDEX)
+    {
+        // NOTE: Events propagate top-to-bottom through the layers interested in them
+        for (const LayerHandle handle : GetEventRoute(typeIndex, event))
+        {
+            if (event.IsConsumed())
+            {
+                break;
+            }
+
+            // NOTE: A layer may have been popped, deleted or disabled by a layer above it during this dispatch
+            Layer *pLayer = GetListedLayer(handle);
+
+            if (pLayer != nullptr && pLayer->IsEnabled())
+            {
+                DispatchToLayer(pLayer, event);
+            }
+        }
+    }
+    else
+    {
+        // NOTE: Nested dispatch after a structural change or an id of no known type, fall back to checking every layer
+        for (auto *pLayer : std::ranges::reverse_view(m_Layers))
         {
-            pLayer->OnEvent(event);
+            if (event.IsConsumed())
+            {
+                break;
+            }
+
+            if (pLayer != nullptr && pLayer->IsEnabled() &&
+                pLayer->HandlesEvent(event.GetTypeId(), event.GetCategory()))
+            {
+                DispatchToLayer(pLayer, event);
+            }
         }
     }
+
+    m_DispatchDepth--;
+
+    if (HasPendingChanges() && !IsIterating())
+    {
+        ApplyPendingChanges();
+    }
 }
 
 void ae::LayerStack::OnUpdate(double deltaTime)
 {
+    BeginPhase();
+
     // NOTE: Update propagates bottom-to-top
-    for (Layer *pLayer : m_Layers)
+    for (const LayerHandle handle : m_UpdateLayers)
     {
-        if (pLayer != nullptr && pLayer->IsEnabled())
+        if (Layer *pLayer = GetPhaseLayer(handle))
         {
-            pLayer->OnUpdate(deltaTime);
+            InvokeTraced(pLayer, "update", [pLayer, deltaTime] { pLayer->OnUpdate(deltaTime); });
         }
     }
+
+    EndPhase();
+}
+
+void ae::LayerStack::OnUpdateParallel(double deltaTime, ThreadPool &threadPool)
+{
+    BeginPhase();
+
+    // NOTE: Ungrouped layers update in place, each run of grouped layers between them is one parallel segment
+    size_t index = 0;
+
+    while (index < m_UpdateLayers.size())
+    {
+        Layer *pLayer = GetPhaseLayer(m_UpdateLayers[index]);
+
+        if (pLayer == nullptr || pLayer->GetUpdateGroup() == 0)
+        {
+            if (pLayer != nullptr)
+            {
+                InvokeTraced(pLayer, "update", [pLayer, deltaTime] { pLayer->OnUpdate(deltaTime); });
+            }
+
+            index++;
+            continue;
+        }
+
+        size_t end = index + 1;
+
+        while (end < m_UpdateLayers.size())
+        {
+            const Layer *pNext = GetPhaseLayer(m_UpdateLayers[end]);
+
+            if (pNext != nullptr && pNext->GetUpdateGroup() == 0)
+            {
+                break;
+            }
+
+            end++;
+        }
+
+        UpdateGroupsParallel(index, end, deltaTime, threadPool);
+        index = end;
+    }
+
+    EndPhase();
 }
 
 void ae::LayerStack::OnRender()
 {
+    BeginPhase();
+
     // NOTE: Render propagates bottom-to-top
-    for (Layer *pLayer : m_Layers)
+    for (const LayerHandle handle : m_RenderLayers)
     {
-        if (pLayer != nullptr && pLayer->IsEnabled())
+        if (Layer *pLayer = GetPhaseLayer(handle))
         {
-            pLayer->OnRender();
+            InvokeTraced(pLayer, "render", [pLayer] { pLayer->OnRender(); });
         }
     }
+
+    EndPhase();
 }
 
 void ae::LayerStack::OnImGuiRender()
 {
+    BeginPhase();
+
     // NOTE: ImGui render propagates bottom-to-top
+    for (const LayerHandle handle : m_ImGuiRenderLayers)
+    {
+        if (Layer *pLayer = GetPhaseLayer(handle))
+        {
+            InvokeTraced(pLayer, "imgui", [pLayer] { pLayer->OnImGuiRender(); });
+        }
+    }
+
+    EndPhase();
+}
+
+ae::LayerHandle ae::LayerStack::Register(Layer *pLayer, bool overlay)
+{
+    uint32_t index = m_FreeSlots;
+
+    if (index != LayerHandle::INVALID_INDEX)
+    {
+        m_FreeSlots = m_Slots[index].NextFree;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_Slots.size());
+        m_Slots.emplace_back();
+    }
+
+    LayerSlot &slot = m_Slots[index];
+    slot.pLayer = pLayer;
+    slot.Overlay = overlay;
+
+    pLayer->m_pLayerStack = this;
+    pLayer->m_Handle = LayerHandle{ .Index = index, .Generation = slot.Generation };
+
+    if (IsIterating())
+    {
+        m_PendingLayers.push_back(PendingLayer{ .pLayer = pLayer, .Overlay = overlay });
+    }
+    else
+    {
+        Insert(pLayer, overlay);
+    }
+
+    return pLayer->m_Handle;
+}
+
+void ae::LayerStack::Insert(Layer *pLayer, bool overlay)
+{
+    if (overlay)
+    {
+        // NOTE: Overlays go at the end
+        pLayer->m_StackIndex = static_cast<uint32_t>(m_Layers.size());
+        m_Layers.push_back(pLayer);
+    }
+    else
+    {
+        // NOTE: Insert before overlays, which move up by one
+        m_Layers.insert(m_Layers.begin() + m_LayerInsertIndex, pLayer);
+
+        for (size_t i = m_LayerInsertIndex; i < m_Layers.size(); i++)
+        {
+            if (m_Layers[i] != nullptr)
+            {
+                m_Layers[i]->m_StackIndex = static_cast<uint32_t>(i);
+            }
+        }
+
+        m_LayerInsertIndex++;
+    }
+
+    Attach(pLayer);
+}
+
+void ae::LayerStack::Unregister(Layer *pLayer)
+{
+    LayerSlot &slot = m_Slots[pLayer->m_Handle.Index];
+    slot.pLayer = nullptr;
+    slot.Generation++;
+    slot.NextFree = m_FreeSlots;
+    m_FreeSlots = pLayer->m_Handle.Index;
+    pLayer->m_Handle = LayerHandle{};
+
+    if (pLayer->m_StackIndex == Layer::INVALID_STACK_INDEX)
+    {
+        // NOTE: Still queued, so it was never attached
+        for (PendingLayer &pending : m_PendingLayers)
+        {
+            if (pending.pLayer == pLayer)
+            {
+                pending.pLayer = nullptr;
+            }
+        }
+
+        pLayer->m_pLayerStack = nullptr;
+        return;
+    }
+
+    const uint32_t stackIndex = pLayer->m_StackIndex;
+    pLayer->m_StackIndex = Layer::INVALID_STACK_INDEX;
+
+    if (IsIterating())
+    {
+        // NOTE: Dispatches and phases in progress skip the layer, the slot is compacted at the next safe point
+        m_Layers[stackIndex] = nullptr;
+        m_RemovedCount++;
+    }
+    else
+    {
+        // NOTE: Nothing is iterating, so no removed slot has to stay visible. Only the layers above it move down
+        m_Layers.erase(m_Layers.begin() + stackIndex);
+        m_LayerInsertIndex -= stackIndex < m_LayerInsertIndex ? 1 : 0;
+
+        for (size_t i = stackIndex; i < m_Layers.size(); i++)
+        {
+            if (m_Layers[i] != nullptr)
+            {
+                m_Layers[i]->m_StackIndex = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    Detach(pLayer);
+}
+
+void ae::LayerStack::CompactLayers() noexcept
+{
+    size_t count = 0;
+    uint32_t layerInsertIndex = 0;
+
+    for (size_t i = 0; i < m_Layers.size(); i++)
+    {
+        Layer *pLayer = m_Layers[i];
+
+        if (pLayer == nullptr)
+        {
+            continue;
+        }
+
+        if (i < m_LayerInsertIndex)
+        {
+            layerInsertIndex++;
+        }
+
+        pLayer->m_StackIndex = static_cast<uint32_t>(count);
+        m_Layers[count++] = pLayer;
+    }
+
+    m_Layers.resize(count);
+    m_LayerInsertIndex = layerInsertIndex;
+    m_RemovedCount = 0;
+}
+
+void ae::LayerStack::Attach(Layer *pLayer)
+{
+    InvalidateEventRoutes();
+    InvalidatePhases();
+    pLayer->OnAttach();
+}
+
+void ae::LayerStack::Detach(Layer *pLayer)
+{
+    pLayer->m_pLayerStack = nullptr;
+#ifdef AE_EVENT_INSTRUMENTATION
+    EventInstrumentation::Get().OnLayerDetached(pLayer);
+#endif
+    InvalidateEventRoutes();
+    InvalidatePhases();
+    pLayer->OnDetach();
+}
+
+void ae::LayerStack::RebuildPhases()
+{
+    m_UpdateLayers.clear();
+    m_RenderLayers.clear();
+    m_ImGuiRenderLayers.clear();
+
     for (Layer *pLayer : m_Layers)
     {
-        if (pLayer != nullptr && pLayer->IsEnabled())
+        if (pLayer == nullptr || !pLayer->IsEnabled())
+        {
+            continue;
+        }
+
+        if (pLayer->ImplementsHook(LayerHook::UPDATE))
+        {
+            m_UpdateLayers.push_back(pLayer->m_Handle);
+        }
+
+        if (pLayer->ImplementsHook(LayerHook::RENDER))
+        {
+            m_RenderLayers.push_back(pLayer->m_Handle);
+        }
+
+        if (pLayer->ImplementsHook(LayerHook::IMGUI_RENDER))
+        {
+            m_ImGuiRenderLayers.push_back(pLayer->m_Handle);
+        }
+    }
+
+    m_PhasesDirty = false;
+}
+
+void ae::LayerStack::UpdateGroupsParallel(size_t begin, size_t end, double deltaTime, ThreadPool &threadPool)
+{
+    m_UpdateGroupTasks.clear();
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const Layer *pLayer = GetPhaseLayer(m_UpdateLayers[i]);
+
+        if (pLayer == nullptr)
+        {
+            continue;
+        }
+
+        const uint32_t group = pLayer->GetUpdateGroup();
+
+        auto matchesGroup = [group](const UpdateGroupTask &task) { return task.Group == group; };
+
+        if (std::ranges::none_of(m_UpdateGroupTasks, matchesGroup))
+        {
+            m_UpdateGroupTasks.push_back(UpdateGroupTask{ .pLayerStack = this,
+                                                          .pBegin = m_UpdateLayers.data() + i,
+                                                          .pEnd = m_UpdateLayers.data() + end,
+                                                          .Group = group,
+                                                          .DeltaTime = deltaTime });
+        }
+    }
+
+    // NOTE: Each task walks the segment from its first layer and updates only the layers of its own group, in order
+    auto runGroup = [](void *pContext)
+    {
+        const auto *pTask = static_cast<const UpdateGroupTask *>(pContext);
+
+        for (const LayerHandle *pHandle = pTask->pBegin; pHandle != pTask->pEnd; pHandle++)
+        {
+            Layer *pLayer = pTask->pLayerStack->GetPhaseLayer(*pHandle);
+
+            if (pLayer != nullptr && pLayer->GetUpdateGroup() == pTask->Group)
+            {
+                InvokeTraced(pLayer, "update", [pLayer, pTask] { pLayer->OnUpdate(pTask->DeltaTime); });
+            }
+        }
+    };
+
+    if (m_UpdateGroupTasks.size() == 1)
+    {
+        runGroup(m_UpdateGroupTasks.data());
+        return;
+    }
+
+    TaskLatch latch;
+
+    for (UpdateGroupTask &task : m_UpdateGroupTasks)
+    {
+        threadPool.Submit(Task{ .pFunction = runGroup, .pContext = &task }, latch);
+    }
+
+    threadPool.Wait(latch);
+}
+
+void ae::LayerStack::DispatchToLayer(Layer *pLayer, Event &event)
+{
+#ifdef AE_EVENT_INSTRUMENTATION
+    EventInstrumentation &instrumentation = EventInstrumentation::Get();
+
+    if (instrumentation.IsEnabled())
+    {
+        const uint32_t layerIndex = instrumentation.GetLayerIndex(pLayer);
+        const uint64_t start = EventInstrumentation::ReadTimestamp();
+        pLayer->OnEvent(event);
+        instrumentation.RecordLayer(layerIndex, event.IsConsumed(), EventInstrumentation::ReadTimestamp() - start);
+        return;
+    }
+#endif
+
+    pLayer->OnEvent(event);
+}
+
+const std::vector<ae::LayerHandle> &ae::LayerStack::GetEventRoute(uint32_t typeIndex, const Event &event)
+{
+    if (typeIndex >= m_EventRoutes.size())
+    {
+        m_EventRoutes.resize(std::max(typeIndex + 1, GetEventTypeCount()));
+    }
+
+    EventRoute &route = m_EventRoutes[typeIndex];
+
+    if (!route.Built)
+    {
+        // NOTE: Assumes every event of a type has the same categories, which holds for all built-in events
+        for (auto *pLayer : std::ranges::reverse_view(m_Layers))
         {
-            pLayer->OnImGuiRender();
+            if (pLayer != nullptr && pLayer->IsEnabled() &&
+                pLayer->HandlesEvent(event.GetTypeId(), event.GetCategory()))
+            {
+                route.Layers.push_back(pLayer->m_Handle);
+            }
         }
+
+        route.Built = true;
     }
+
+    return route.Layers;
 }
@@ -0,0 +1,190 @@
+#include "general/pch.h"
+
+#include "ThreadPool.h"
+
+namespace
+{
+
+// NOTE: Index of the worker queue owned by the current thread, UINT32_MAX on threads outside the pool
+thread_local uint32_t t_WorkerIndex = UINT32_MAX;
+
+} // namespace
+
+ae::ThreadPool::ThreadPool(uint32_t workerCount) : m_QueueCount(std::max<uint32_t>(workerCount, 1))
+{
+    m_pQueues = std::make_unique<WorkerQueue[]>(m_QueueCount);
+    m_Threads.reserve(workerCount);
+
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        m_Threads.emplace_back([this, i] { WorkerLoop(i); });
+    }
+
+    AE_LOG(AE_TRACE, "Started ThreadPool with {} workers", workerCount);
+}
+
+ae::ThreadPool::~ThreadPool()
+{
+    m_Running.store(false, std::memory_order_release);
+    m_WorkSignal.fetch_add(1, std::memory_order_release);
+    m_WorkSignal.notify_all();
+
+    for (std::thread &thread : m_Threads)
+    {
+        thread.join();
+    }
+
+    // NOTE: Without workers, or if tasks were submitted after the workers stopped, finish them here
+    while (TryRunOne(0))
+    {
+    }
+}
+
+void ae::ThreadPool::Submit(Task task, TaskLatch &latch)
+{
+    latch.Add();
+
+    const QueuedTask queued{ .Work = task, .pLatch = &latch };
+
+    // NOTE: Workers push to their own deque, other threads spread tasks round-robin
+    const uint32_t first = t_WorkerIndex != UINT32_MAX
+                               ? t_WorkerIndex
+                               : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_QueueCount;
+
+    for (uint32_t i = 0; i < m_QueueCount; i++)
+    {
+        if (TryPush((first + i) % m_QueueCount, queued))
+        {
+            m_WorkSignal.fetch_add(1, std::memory_order_release);
+            m_WorkSignal.notify_one();
+            return;
+        }
+    }
+
+    Run(queued);
+}
+
+void ae::ThreadPool::Wait(TaskLatch &latch)
+{
+    const uint32_t preferred = t_WorkerIndex != UINT32_MAX ? t_WorkerIndex : 0;
+
+    while (!latch.IsDone())
+    {
+        if (TryRunOne(preferred))
+        {
+            continue;
+        }
+
+        // NOTE: Nothing left to help with, sleep until the remaining tasks finish on the workers
+        const uint32_t pending = latch.m_Pending.load(std::memory_order_acquire);
+
+        if (pending != 0)
+        {
+            latch.m_Pending.wait(pending, std::memory_order_acquire);
+        }
+    }
+}
+
+uint32_t ae::ThreadPool::GetDefaultWorkerCount() noexcept
+{
+    const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    return hardwareThreads - 1;
+}
+
+void ae::ThreadPool::WorkerLoop(uint32_t workerIndex)
+{
+    t_WorkerIndex = workerIndex;
+
+    while (true)
+    {
+        const uint32_t signal = m_WorkSignal.load(std::memory_order_acquire);
+
+        if (TryRunOne(workerIndex))
+        {
+            continue;
+        }
+
+        if (!m_Running.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        // NOTE: The signal was read before looking for work, so a submit in between wakes this wait immediately
+        m_WorkSignal.wait(signal, std::memory_order_acquire);
+    }
+
+    t_WorkerIndex = UINT32_MAX;
+}
+
+bool ae::ThreadPool::TryPush(uint32_t queueIndex, const QueuedTask &task)
+{
+    WorkerQueue &queue = m_pQueues[queueIndex];
+    const std::lock_guard lock(queue.Mutex);
+
+    if (queue.Tail - queue.Head == MAX_QUEUED_TASKS_PER_WORKER)
+    {
+        return false;
+    }
+
+    queue.Tasks[queue.Tail % MAX_QUEUED_TASKS_PER_WORKER] = task;
+    queue.Tail++;
+    return true;
+}
+
+bool ae::ThreadPool::TryPopOwn(uint32_t queueIndex, QueuedTask &task)
+{
+    WorkerQueue &queue = m_pQueues[queueIndex];
+    const std::lock_guard lock(queue.Mutex);
+
+    if (queue.Tail == queue.Head)
+    {
+        return false;
+    }
+
+    queue.Tail--;
+    task = queue.Tasks[queue.Tail % MAX_QUEUED_TASKS_PER_WORKER];
+    return true;
+}
+
+bool ae::ThreadPool::TrySteal(uint32_t queueIndex, QueuedTask &task)
+{
+    WorkerQueue &queue = m_pQueues[queueIndex];
+    const std::lock_guard lock(queue.Mutex);
+
+    if (queue.Tail == queue.Head)
+    {
+        return false;
+    }
+
+    task = queue.Tasks[queue.Head % MAX_QUEUED_TASKS_PER_WORKER];
+    queue.Head++;
+    return true;
+}
+
+bool ae::ThreadPool::TryRunOne(uint32_t preferredQueue)
+{
+    QueuedTask task;
+
+    if (TryPopOwn(preferredQueue, task))
+    {
+        Run(task);
+        return true;
+    }
+
+    for (uint32_t i = 1; i < m_QueueCount; i++)
+    {
+        if (TrySteal((preferredQueue + i) % m_QueueCount, task))
+        {
+            Run(task);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ae::ThreadPool::Run(const QueuedTask &task) noexcept
+{
+    task.Work.pFunction(task.Work.pContext);
+    task.pLatch->CountDown();
+}
@@ -114,6 +114,23 @@ includedirs({
 
 links({ "Event", "Log" })
 
+project("Benchmark")
+kind("ConsoleApp")
+language("C++")
+cppdialect("C++23")
+objdir("obj/%{prj.name}/%{cfg.buildcfg}")
+targetdir("bin/%{prj.name}/%{cfg.buildcfg}")
+
+files({ "benchmark/src/**.cpp", "benchmark/src/**.h" })
+
+includedirs({
+	"dep/log-lib/log-lib/include",
+	"event-lib/include",
+	"benchmark/src",
+})
+
+links({ "Event", "Log" })
+
 local function own_source_files()
 	local files = {}
 
@@ -135,6 +152,11 @@ local function own_source_files()
 	add("sandbox/src/**.h")
 	add("sandbox/src/**.hpp")
 
+	add("benchmark/src/**.cpp")
+	add("benchmark/src/**.c")
+	add("benchmark/src/**.h")
+	add("benchmark/src/**.hpp")
+
 	return files
 end
 
@@ -1,3 +1,4 @@
+#include "EventDispatcher.h"
 #include "Layer.h"
 #include "Log.h"
 
@@ -27,7 +28,11 @@ class PlayerDiedEvent final : public ae::Event
 class InputLayer : public ae::Layer
 {
   public:
-    InputLayer() : Layer("Input") {}
+    InputLayer() : Layer("Input")
+    {
+        // Only key presses and mouse movement are routed to this layer by the LayerStack
+        SubscribeToEvents<ae::KeyPressedEvent, ae::MouseMovedEvent>();
+    }
 
   private:
     void OnAttach() override
@@ -42,26 +47,25 @@ class InputLayer : public ae::Layer
 
     void OnEvent(ae::Event &event) override
     {
-        // Handle key pressed events
-        if (event.GetTypeId() == ae::EventTypeId<ae::KeyPressedEvent>::Get())
-        {
-            auto &keyEvent = static_cast<ae::KeyPressedEvent &>(event);
-            AE_LOG(AE_INFO, "InputLayer: Key pressed: {} (repeat: {})", keyEvent.GetKeyCode(), keyEvent.IsRepeat());
-
-            // Consume the escape key to prevent other layers from handling it
-            if (keyEvent.GetKeyCode() == 256) // GLFW_KEY_ESCAPE
+        // ae::Handle routes the event to the handler matching its type, returning true consumes the event
+        ae::Handle(
+            event,
+            [](ae::KeyPressedEvent &keyEvent)
             {
-                AE_LOG(AE_INFO, "InputLayer: Escape key consumed!");
-                event.Consume();
-            }
-        }
-
-        // Handle mouse moved events
-        if (event.GetTypeId() == ae::EventTypeId<ae::MouseMovedEvent>::Get())
-        {
-            auto &mouseEvent = static_cast<ae::MouseMovedEvent &>(event);
-            AE_LOG(AE_TRACE, "InputLayer: Mouse moved to ({}, {})", mouseEvent.GetX(), mouseEvent.GetY());
-        }
+                AE_LOG(AE_INFO, "InputLayer: Key pressed: {} (repeat: {})", keyEvent.GetKeyCode(),
+                       keyEvent.IsRepeat());
+
+                // Consume the escape key to prevent other layers from handling it
+                if (keyEvent.GetKeyCode() == 256) // GLFW_KEY_ESCAPE
+                {
+                    AE_LOG(AE_INFO, "InputLayer: Escape key consumed!");
+                    return true;
+                }
+
+                return false;
+            },
+            [](ae::MouseMovedEvent &mouseEvent)
+            { AE_LOG(AE_TRACE, "InputLayer: Mouse moved to ({}, {})", mouseEvent.GetX(), mouseEvent.GetY()); });
     }
 
     void OnUpdate(double deltaTime) override
@@ -79,7 +83,10 @@ class InputLayer : public ae::Layer
 class GameOverlay : public ae::Layer
 {
   public:
-    GameOverlay() : Layer("GameOverlay") {}
+    GameOverlay() : Layer("GameOverlay")
+    {
+        SubscribeToEvents<PlayerDiedEvent, ae::KeyPressedEvent>();
+    }
 
   private:
     void OnAttach() override
@@ -95,19 +102,13 @@ class GameOverlay : public ae::Layer
     void OnEvent(ae::Event &event) override
     {
         // Overlays receive events first, before regular layers
-        // This overlay only handles custom events
-        if (event.GetTypeId() == ae::EventTypeId<PlayerDiedEvent>::Get())
-        {
-            auto &playerEvent = static_cast<PlayerDiedEvent &>(event);
-            AE_LOG(AE_WARNING, "GameOverlay: Player {} died!", playerEvent.GetPlayerId());
-        }
-
-        // Demonstrate that overlays can see key events before layers
-        if (event.GetTypeId() == ae::EventTypeId<ae::KeyPressedEvent>::Get())
-        {
-            auto &keyEvent = static_cast<ae::KeyPressedEvent &>(event);
-            AE_LOG(AE_TRACE, "GameOverlay: Saw key press {} (passing through)", keyEvent.GetKeyCode());
-        }
+        // This overlay handles custom events and demonstrates that overlays can see key events before layers
+        ae::Handle(
+            event,
+            [](PlayerDiedEvent &playerEvent)
+            { AE_LOG(AE_WARNING, "GameOverlay: Player {} died!", playerEvent.GetPlayerId()); },
+            [](ae::KeyPressedEvent &keyEvent)
+            { AE_LOG(AE_TRACE, "GameOverlay: Saw key press {} (passing through)", keyEvent.GetKeyCode()); });
     }
 };
 